@@ -0,0 +1,299 @@
+/*
+* Contains the alliance link: both robots of an alliance exchange their pose, velocity, planned target and state
+* in small fixed-size packets, to track the partner and to decide which robot yields when their paths cross.
+* Nothing here touches PROS devices (the radio is behind LinkTransport, see radiotransport.h),
+* so two links can be run against each other on a computer through LoopbackTransport.
+*/
+#ifndef ALLIANCELINK_LS_H
+#define ALLIANCELINK_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ls {
+    /**
+     * @brief State bits sent with every packet, bit i is PartnerFlag i.
+     */
+    enum class PartnerFlag : std::uint8_t {
+        Autonomous, // running its autonomous routine
+        Moving, // faster than a crawl, set by the link from the pose
+        HasTarget, // the target fields hold where it is driving to
+        Yielding, // waiting for the other robot to pass, set by the link
+        Clamped // holding a mobile goal
+    };
+
+    /**
+     * @brief Checks a bit of a flags field.
+     */
+    constexpr bool hasFlag(std::uint16_t flags, PartnerFlag flag) {
+        return (flags >> static_cast<std::uint8_t>(flag)) & 1;
+    }
+
+    /**
+     * @brief One robot's state, in field coordinates: inches from the left and bottom walls, bearing in degrees.
+     */
+    struct AlliancePacket {
+        std::uint16_t sequence = 0;
+        float x = 0;
+        float y = 0;
+        float heading = 0; // [0, 360)
+        float vx = 0; // in in/s
+        float vy = 0;
+        float omega = 0; // in deg/s
+        float targetX = 0;
+        float targetY = 0;
+        std::uint16_t flags = 0;
+    };
+
+    /**
+     * @brief Bytes of an encoded packet: 2 sync bytes, 20 bytes of fixed point fields and a CRC-8.
+     * Positions are sent in 1/100 in, velocities in 1/100 in/s and angles in 1/100 degree (1/10 deg/s for omega).
+     */
+    constexpr std::size_t PACKET_SIZE = 23;
+    using PacketFrame = std::array<std::uint8_t, PACKET_SIZE>;
+
+    /**
+     * @brief Writes a packet into a frame, little endian.
+     */
+    void encodePacket(const AlliancePacket& packet, PacketFrame& frame);
+
+    /**
+     * @brief Reads a frame.
+     *
+     * @param frame PACKET_SIZE bytes.
+     * @param packet filled in if the frame is valid.
+     * @return if the sync bytes and the CRC match.
+     */
+    bool decodePacket(const std::uint8_t* frame, AlliancePacket& packet);
+
+    /**
+     * @brief A byte stream to the partner robot. Sends may be dropped, nothing is framed or retried.
+     */
+    class LinkTransport {
+        public:
+            virtual ~LinkTransport() = default;
+
+            /**
+             * @brief Returns if the other end is there.
+             */
+            virtual bool connected() = 0;
+
+            /**
+             * @brief Sends bytes.
+             * @return the number of bytes accepted, 0 if there was no room. Accepted bytes can still be lost on the way.
+             */
+            virtual std::size_t send(const std::uint8_t* data, std::size_t size) = 0;
+
+            /**
+             * @brief Gets the number of bytes waiting to be received.
+             */
+            virtual std::size_t available() = 0;
+
+            /**
+             * @brief Receives up to 'size' bytes.
+             * @return the number of bytes received.
+             */
+            virtual std::size_t receive(std::uint8_t* dest, std::size_t size) = 0;
+    };
+
+    /**
+     * @brief An in-process transport, the stand-in for the radio when two links run on one computer.
+     * Bytes sent on one end are received on the end it is connected to. Not thread safe,
+     * both ends are meant to be stepped from one thread.
+     */
+    class LoopbackTransport : public LinkTransport {
+        public:
+            static constexpr std::size_t CAPACITY = 512; // bytes in flight, more are dropped like a full radio buffer
+
+            /**
+             * @brief Connects two ends to each other.
+             */
+            static void connect(LoopbackTransport& a, LoopbackTransport& b);
+
+            /**
+             * @brief Drops every n-th send, to test loss. 0 drops nothing.
+             */
+            void setLoss(std::uint32_t everyNth);
+
+            bool connected() override;
+            std::size_t send(const std::uint8_t* data, std::size_t size) override;
+            std::size_t available() override;
+            std::size_t receive(std::uint8_t* dest, std::size_t size) override;
+        private:
+            LoopbackTransport* peer = nullptr;
+            std::array<std::uint8_t, CAPACITY> buffer{};
+            std::size_t head = 0;
+            std::size_t size = 0;
+            std::uint32_t loss = 0;
+            std::uint32_t sends = 0;
+    };
+
+    /**
+     * @brief Tuning of the alliance link.
+     */
+    struct AllianceLinkSettings {
+        std::uint32_t period = 50; // in ms between packets, the radio fits about 20 a second
+        std::uint32_t staleTimeout = 250; // in ms without a packet before the partner is unknown
+        std::uint32_t latency = 15; // in ms, expected age of a packet when it arrives
+        float positionGain = 0.5f; // [0, 1], how far each packet pulls the partner estimate towards it
+        float clearance = 20; // in inches, paths closer than this conflict
+        float movingSpeed = 2; // in in/s, the Moving flag is set above this
+        bool leader = false; // breaks ties, must differ between the two robots
+    };
+
+    /**
+     * @brief Where the partner is thought to be now.
+     */
+    struct PartnerEstimate {
+        bool valid = false; // false until a packet arrives, and once it is stale
+        float x = 0;
+        float y = 0;
+        float heading = 0;
+        float vx = 0;
+        float vy = 0;
+        bool hasTarget = false;
+        float targetX = 0;
+        float targetY = 0;
+        std::uint16_t flags = 0;
+        std::uint32_t age = 0; // in ms since the last packet
+    };
+
+    /**
+     * @brief Counters of the alliance link since boot.
+     */
+    struct LinkStats {
+        std::uint32_t sent = 0;
+        std::uint32_t received = 0;
+        std::uint32_t lost = 0; // missing sequence numbers
+        std::uint32_t stale = 0; // duplicate or out of order packets, ignored
+        std::uint32_t corrupt = 0; // bytes skipped while looking for a valid frame
+    };
+
+    /**
+     * @brief Sends this robot's state and tracks the partner's, call update() once per tick.
+     *
+     * Packets go out every 'period' ms on a fixed schedule (not drifting with the tick), received bytes are
+     * reframed by their sync bytes and CRC, and packets are ordered by sequence number. The partner estimate
+     * blends each packet, moved forward by its latency, into a prediction from the last velocity, so it stays smooth
+     * and keeps moving through a dropped packet.
+     *
+     * Yielding: both robots send the straight segment from their pose to their target. If the two segments come
+     * closer than 'clearance', the robot farther from where they meet yields (the leader wins a tie),
+     * and a robot never yields to a partner that is already yielding.
+     */
+    class AllianceLink {
+        public:
+            /**
+             * @brief Construct a new Alliance Link object
+             *
+             * @param transport the byte stream to the partner, must outlive the link.
+             * @param settings the tuning.
+             */
+            explicit AllianceLink(LinkTransport& transport, AllianceLinkSettings settings = {});
+
+            /**
+             * @brief Sets where odom's origin is on the field, so both robots send field coordinates.
+             *
+             * @param x inches from the left wall.
+             * @param y inches from the bottom wall.
+             * @param heading bearing odom's 0 is facing on the field, in degrees.
+             */
+            void setOrigin(double x, double y, double heading);
+
+            /**
+             * @brief Sets this robot's pose, ex. odom.getPosition() once per tick.
+             *
+             * @param x in odom inches.
+             * @param y in odom inches.
+             * @param heading in odom degrees (bearing).
+             */
+            void setPose(double x, double y, double heading);
+
+            /**
+             * @brief Sets where this robot is driving to, in odom inches.
+             */
+            void setTarget(double x, double y);
+
+            /**
+             * @brief Clears the target, the robot is not driving anywhere planned.
+             */
+            void clearTarget();
+
+            /**
+             * @brief Sets or clears a state flag. Moving and Yielding are set by the link and can't be set here.
+             */
+            void setFlag(PartnerFlag flag, bool on);
+
+            /**
+             * @brief Receives, updates the partner estimate and yield decision, and sends when a packet is due.
+             *
+             * @param now time in ms, ex. pros::millis().
+             */
+            void update(std::uint32_t now);
+
+            /**
+             * @brief Gets the partner estimate moved forward to 'now'.
+             */
+            PartnerEstimate getPartner(std::uint32_t now) const;
+
+            /**
+             * @brief Returns if a packet arrived in the last staleTimeout ms.
+             */
+            bool isPartnerFresh(std::uint32_t now) const;
+
+            /**
+             * @brief Returns if this robot should wait for the partner to pass, as of the last update().
+             */
+            bool shouldYield() const;
+
+            /**
+             * @brief Gets this robot's pose in field coordinates, as sent.
+             */
+            AlliancePacket getLocal() const;
+
+            /**
+             * @brief Gets the counters.
+             */
+            LinkStats getStats() const;
+        private:
+            void receive(std::uint32_t now);
+            void accept(const AlliancePacket& packet, std::uint32_t now);
+            void updateYield(std::uint32_t now);
+            void send(std::uint32_t now);
+
+            LinkTransport& transport;
+            AllianceLinkSettings settings;
+
+            double originX = 0;
+            double originY = 0;
+            double originHeading = 0; // in degrees
+            double originSin = 0;
+            double originCos = 1;
+
+            AlliancePacket local;
+            bool hasPose = false;
+            std::uint16_t localFlags = 0; // set by setFlag()
+            float lastSentX = 0;
+            float lastSentY = 0;
+            float lastSentHeading = 0;
+            std::uint32_t nextSend = 0;
+            std::uint32_t lastSend = 0;
+            bool sentOnce = false;
+
+            std::array<std::uint8_t, 2 * PACKET_SIZE> rx{};
+            std::size_t rxSize = 0;
+
+            AlliancePacket partner;
+            bool hasPartner = false;
+            std::uint32_t partnerTime = 0; // when the estimate was last corrected
+            float estimateX = 0;
+            float estimateY = 0;
+            float estimateHeading = 0;
+            bool yielding = false;
+
+            LinkStats stats;
+    };
+}
+
+#endif // ALLIANCELINK_LS_H
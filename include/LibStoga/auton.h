@@ -0,0 +1,139 @@
+/*
+* Contains the autonomous routine registry and the brain screen selector.
+* Routines are declared in a constexpr table so the list is checked at compile time,
+* and the chosen routine is built before the match so autonomous() only has to run it.
+*/
+#ifndef AUTON_LS_H
+#define AUTON_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "command.h"
+
+namespace ls {
+    /**
+     * @brief The starting side a routine was written for.
+     */
+    enum class AutonSide : std::uint8_t {
+        Left,
+        Right,
+        Skills,
+        Any
+    };
+
+    /**
+     * @brief The alliance a routine was written for.
+     */
+    enum class AllianceColor : std::uint8_t {
+        Red,
+        Blue,
+        Any
+    };
+
+    /**
+     * @brief One entry in the auton table.
+     */
+    struct AutonRoutine {
+        const char* name;
+        AutonSide side;
+        AllianceColor color;
+        Command (*routine)(); // builds the routine, should not do any work until awaited.
+        void (*prewarm)() = nullptr; // optional, generates paths/profiles before the match.
+    };
+
+    /**
+     * @brief The most routines a table can hold (the selector grid has this many buttons).
+     */
+    constexpr std::size_t MAX_AUTONS = 12;
+
+    /**
+     * @brief Checks an auton table at compile time.
+     * Every routine needs a name and a function, names must be unique and the table must fit on screen.
+     * Meant to be used inside a static_assert.
+     *
+     * @param table the table to check.
+     * @return if the table is valid.
+     */
+    template<std::size_t N>
+    constexpr bool validateAutonTable(const std::array<AutonRoutine, N>& table) {
+        if (N == 0 || N > MAX_AUTONS) return false;
+        for (std::size_t i = 0; i < N; i++) {
+            if (table[i].name == nullptr || table[i].routine == nullptr) return false;
+            for (std::size_t j = i + 1; j < N; j++) {
+                if (table[j].name == nullptr) return false;
+                const char* a = table[i].name;
+                const char* b = table[j].name;
+                while (*a != '\0' && *a == *b) {
+                    a++;
+                    b++;
+                }
+                if (*a == *b) return false; // duplicate name
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lets the drive team pick a routine on the brain screen, and keeps it ready to run.
+     *
+     * Picking a routine runs its prewarm function and builds its Command right away,
+     * so nothing has to be generated or allocated once autonomous() starts.
+     */
+    class AutonSelector {
+    public:
+        /**
+         * @brief Construct a new Auton Selector object
+         *
+         * @param table the constexpr table of routines, must outlive the selector.
+         */
+        template<std::size_t N>
+        explicit AutonSelector(const std::array<AutonRoutine, N>& table): table(table.data()), count(N) {
+            static_assert(N > 0 && N <= MAX_AUTONS, "auton table must have between 1 and MAX_AUTONS routines.");
+        }
+        /**
+         * @brief Picks a routine and gets it ready to run.
+         *
+         * @param index index of the routine in the table.
+         * @throws std::out_of_range if the index is not in the table.
+         */
+        void select(std::size_t index);
+        /**
+         * @brief Draws the routines on the brain screen and handles touches until the task is stopped.
+         * Meant to be called from competition_initialize(), which PROS stops once the match starts.
+         */
+        void runSelector();
+        /**
+         * @brief Returns the routine that is currently picked.
+         */
+        const AutonRoutine& getSelected() const;
+        /**
+         * @brief Returns the index of the routine that is currently picked.
+         */
+        std::size_t getSelectedIndex() const;
+        /**
+         * @brief Hands over the built Command of the picked routine.
+         * If it was already taken, it is rebuilt (only expected when testing outside of a match).
+         *
+         * @return the routine, ready to give to a Scheduler.
+         */
+        Command take();
+    private:
+        /**
+         * @brief Redraws every button, highlighting the selected one.
+         */
+        void draw() const;
+        /**
+         * @brief Returns the index of the button at the given point, or count if there is none.
+         */
+        std::size_t buttonAt(std::int16_t x, std::int16_t y) const;
+
+        const AutonRoutine* table;
+        std::size_t count;
+        std::size_t selected = 0;
+        std::uint32_t prewarmed = 0; // bit i is set once routine i has been prewarmed.
+        Command prepared;
+    };
+}
+
+#endif // AUTON_LS_H
@@ -0,0 +1,232 @@
+/*
+* Contains the ring color sorter: an optical sensor on the conveyor is sampled by a high priority task,
+* each ring is classified and timestamped, and opponent rings are ejected at the moment they reach the ejector,
+* predicted from the conveyor speed.
+*/
+#ifndef COLORSORT_LS_H
+#define COLORSORT_LS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief The color of a ring, None if there is no ring in front of the sensor.
+     */
+    enum class RingColor : std::uint8_t {
+        None,
+        Red,
+        Blue
+    };
+
+    /**
+     * @brief A range of hues around a center, in degrees.
+     * A ring is recognized inside 'enter' of the center and only lost outside 'exit', so a hue
+     * flickering on the edge of the band does not split one ring into two.
+     */
+    struct HueBand {
+        float center;
+        float enter; // half width, in degrees
+        float exit; // half width, in degrees, >= enter
+    };
+
+    /**
+     * @brief Tuning of the color sorter.
+     */
+    struct ColorSortSettings {
+        HueBand red{10, 20, 35};
+        HueBand blue{215, 30, 45};
+        std::int32_t proximityEnter = 140; // [0, 255], a ring is at least this close to be classified
+        std::int32_t proximityExit = 90; // [0, 255], the ring is gone once farther than this
+        std::uint8_t confirmSamples = 2; // samples in a row a color needs before it counts as a ring
+        std::uint32_t samplePeriod = 5; // in ms, the sensor updates every ~10ms, polling faster halves the wait for new data
+        std::uint32_t actuationDelay = 15; // in ms, from the extend action until the ejector actually hits the ring
+        std::uint32_t ejectTime = 100; // in ms, how long the ejector stays extended
+        float minSpeed = 2; // in in/s, below this (or backwards) the arrival can't be predicted and the ring is not ejected
+    };
+
+    /**
+     * @brief Turns optical samples into ring events, with hysteresis on both the hue and the proximity.
+     * Holds no device, so it can be fed recorded samples.
+     */
+    class RingClassifier {
+        public:
+            /**
+             * @brief Construct a new Ring Classifier object
+             *
+             * @param settings the bands and thresholds, must outlive the classifier.
+             */
+            explicit RingClassifier(const ColorSortSettings& settings);
+
+            /**
+             * @brief Feeds one sample.
+             *
+             * @param hue the hue in degrees [0, 360).
+             * @param proximity the proximity [0, 255], higher is closer.
+             * @param time when the sample was read, in any unit.
+             * @return the color of a ring that was just confirmed, None otherwise (once per ring).
+             */
+            RingColor update(double hue, std::int32_t proximity, std::uint64_t time);
+
+            /**
+             * @brief Gets the color of the ring in front of the sensor, None if there is none.
+             */
+            RingColor getCurrent() const;
+
+            /**
+             * @brief Gets when the current ring was first seen, the first of its confirming samples.
+             */
+            std::uint64_t getSince() const;
+
+            /**
+             * @brief Forgets the current ring.
+             */
+            void reset();
+        private:
+            RingColor classify(double hue, float HueBand::*width) const;
+
+            const ColorSortSettings& settings;
+            RingColor current = RingColor::None;
+            RingColor candidate = RingColor::None;
+            std::uint8_t streak = 0;
+            std::uint64_t since = 0;
+    };
+
+    /**
+     * @brief One ring that went past the sensor.
+     */
+    struct RingRecord {
+        RingColor color = RingColor::None;
+        std::uint64_t detectedAt = 0; // in µs since boot
+        float speed = 0; // conveyor speed at detection, in in/s
+        std::uint64_t ejectAt = 0; // in µs since boot, when the ejector was scheduled to extend, 0 if it was not ejected
+    };
+
+    /**
+     * @brief Samples an optical sensor and ejects rings of one color.
+     *
+     * When a ring is confirmed, the conveyor speed is read once and the time the ring reaches the ejector is predicted
+     * (distance / speed, minus the ejector's actuation delay). The task then sleeps until the earliest of the next sample
+     * or the next scheduled action, so an eject fires on the RTOS tick it is due instead of at the next sample.
+     * The task runs above the control loop, it only holds the CPU for a sample and is otherwise asleep.
+     */
+    class ColorSorter {
+        public:
+            static constexpr std::size_t MAX_PENDING = 4; // rings between the sensor and the ejector
+            using Action = std::function<void()>;
+
+            /**
+             * @brief Construct a new Color Sorter object
+             *
+             * @param opticalPort the port of the optical sensor.
+             * @param conveyor the conveyor motor(s), only their velocity is read. Must outlive the sorter.
+             * @param inchesPerTurn conveyor travel per motor (cartridge output) turn, in inches.
+             * @param ejectDistance distance along the conveyor from the sensor to the ejector, in inches.
+             * @param settings the tuning.
+             * @throws std::invalid_argument if inchesPerTurn is not positive or ejectDistance is negative.
+             */
+            ColorSorter(std::uint8_t opticalPort, pros::v5::AbstractMotor& conveyor, float inchesPerTurn, float ejectDistance, ColorSortSettings settings = {});
+            ~ColorSorter();
+
+            /**
+             * @brief Sets the actions that move the ejector. They run inside the sorter task and must not block.
+             * Call before start().
+             *
+             * @param extend pushes the ring off, ex. extends a piston.
+             * @param retract returns the ejector, called ejectTime after extend.
+             */
+            void onEject(Action extend, Action retract);
+
+            /**
+             * @brief Sets a function called with the color of every ring that goes past the sensor, ex. to count them.
+             * Runs inside the sorter task and must not block. Call before start().
+             */
+            void onRing(std::function<void(RingColor color)> callback);
+
+            /**
+             * @brief Sets which color is ejected, None to keep every ring. Safe to call from any task.
+             */
+            void setEjectColor(RingColor color);
+
+            /**
+             * @brief Gets which color is ejected.
+             */
+            RingColor getEjectColor() const;
+
+            /**
+             * @brief Turns on the sensor's LED and starts the sorter task.
+             */
+            void start();
+
+            /**
+             * @brief Stops the sorter task, a pending eject is dropped and an extended ejector is retracted.
+             */
+            void stop();
+
+            /**
+             * @brief Gets the last ring that went past the sensor.
+             */
+            RingRecord getLastRing();
+
+            /**
+             * @brief Gets the number of rings of a color that went past the sensor.
+             */
+            std::uint32_t getCount(RingColor color) const;
+
+            /**
+             * @brief Gets the number of rings that were ejected.
+             */
+            std::uint32_t getEjected() const;
+
+            /**
+             * @brief Gets the number of rings that should have been ejected but were not:
+             * the conveyor was too slow, or too many rings were waiting.
+             */
+            std::uint32_t getMissed() const;
+
+            /**
+             * @brief Gets the latest an eject ever fired after its scheduled time, in µs.
+             */
+            std::uint32_t getMaxLateness() const;
+        private:
+            void loop();
+            void sample(std::uint64_t now);
+            void schedule(RingColor color, std::uint64_t detectedAt, std::uint64_t now);
+            void act(std::uint64_t now);
+            std::uint64_t nextWake(std::uint64_t now) const;
+
+            pros::Optical optical;
+            pros::v5::AbstractMotor& conveyor;
+            float inchesPerRpm;
+            float ejectDistance;
+            ColorSortSettings settings;
+            RingClassifier classifier;
+            Action extend;
+            Action retract;
+            std::function<void(RingColor color)> ringCallback;
+
+            // only used by the task.
+            std::array<std::uint64_t, MAX_PENDING> pending{}; // extend times in µs, sorted
+            std::size_t pendingCount = 0;
+            bool extended = false;
+            std::uint64_t retractAt = 0;
+
+            std::atomic<RingColor> ejectColor = RingColor::None;
+            std::array<std::atomic<std::uint32_t>, 3> counts{}; // indexed by RingColor
+            std::atomic<std::uint32_t> ejected = 0;
+            std::atomic<std::uint32_t> missed = 0;
+            std::atomic<std::uint32_t> maxLateness = 0;
+            RingRecord last; // under the mutex
+
+            pros::Mutex mutex;
+            std::unique_ptr<pros::Task> task = nullptr;
+            std::atomic<bool> running = false;
+    };
+}
+
+#endif // COLORSORT_LS_H
@@ -0,0 +1,368 @@
+/*
+* Contains the coroutine based command framework used for autonomous routines.
+* Commands are C++20 coroutines that are all driven from a single Scheduler loop,
+* so many actions (driving, intake, lifts...) can overlap without spawning a pros::Task for each.
+*/
+#ifndef COMMAND_LS_H
+#define COMMAND_LS_H
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include "odom.h"
+#include "pid.h"
+#include "geometry.h"
+
+namespace ls {
+    class Scheduler;
+
+    /**
+     * @brief Fixed block of memory that every Command frame is carved from.
+     *
+     * Frames are rounded up to a size class and recycled through per-class free lists,
+     * so once a routine is running no coroutine touches the heap.
+     * The size of the block can be changed by defining LS_FRAME_ARENA_SIZE.
+     * Frames are expected to be created and destroyed from one task at a time (the scheduler's).
+     */
+    class FrameArena {
+    public:
+        /**
+         * @brief Gets memory for a coroutine frame.
+         * Falls back to the heap if the frame is too big or the arena is full.
+         *
+         * @param size size of the frame in bytes.
+         */
+        static void* allocate(std::size_t size);
+        /**
+         * @brief Gives back memory from allocate().
+         *
+         * @param ptr the frame memory.
+         * @param size size of the frame in bytes.
+         */
+        static void deallocate(void* ptr, std::size_t size);
+        /**
+         * @brief Returns how many bytes of the arena have been handed out at some point.
+         */
+        static std::size_t getUsed();
+        /**
+         * @brief Returns how many frames had to go to the heap because they did not fit.
+         * Should stay at 0 during a match, raise LS_FRAME_ARENA_SIZE if it does not.
+         */
+        static std::size_t getHeapFallbacks();
+    };
+
+    /**
+     * @brief A unit of autonomous work, written as a coroutine.
+     *
+     * Any function returning a Command can use co_await on the primitives in this file
+     * (wait, until, nextTick, drive, turn) or on other Commands.
+     * Commands are lazy: nothing runs until it is awaited or given to a Scheduler.
+     *
+     * Destroying a Command that has not finished cancels it (and everything it is awaiting).
+     */
+    class Command {
+    public:
+        struct promise_type {
+            Scheduler* scheduler = nullptr;
+            std::coroutine_handle<> continuation = nullptr;
+            std::exception_ptr exception = nullptr;
+            bool waiting = false; // true while registered with the scheduler.
+
+            Command get_return_object();
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            auto final_suspend() noexcept {
+                struct FinalAwaiter {
+                    bool await_ready() noexcept { return false; }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                        std::coroutine_handle<> next = h.promise().continuation;
+                        return next ? next : std::noop_coroutine();
+                    }
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+            void return_void() {}
+            void unhandled_exception() { exception = std::current_exception(); }
+            static void* operator new(std::size_t size) { return FrameArena::allocate(size); }
+            static void operator delete(void* ptr, std::size_t size) { FrameArena::deallocate(ptr, size); }
+            ~promise_type();
+        };
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        Command() = default;
+        Command(Command&& other) noexcept;
+        Command& operator=(Command&& other) noexcept;
+        Command(const Command&) = delete;
+        Command& operator=(const Command&) = delete;
+        ~Command();
+
+        /**
+         * @brief Returns if this command has run to completion (or holds nothing).
+         */
+        bool done() const;
+        /**
+         * @brief Stops this command where it is and frees it.
+         * Anything the command was awaiting is cancelled too.
+         */
+        void cancel();
+        /**
+         * @brief Starts running this command on the given scheduler without anyone awaiting it.
+         * It will run until its first suspension before this returns.
+         *
+         * @param scheduler the scheduler that will keep resuming this command.
+         */
+        void start(Scheduler& scheduler);
+        /**
+         * @brief Rethrows the exception this command finished with, if any.
+         */
+        void rethrow() const;
+
+        /**
+         * @brief Makes co_await on a command run it as a child, resuming the parent when it is done.
+         */
+        auto operator co_await() & noexcept { return Awaiter{handle}; }
+        auto operator co_await() && noexcept { return Awaiter{handle}; }
+    private:
+        explicit Command(handle_type h): handle(h) {}
+
+        struct Awaiter {
+            handle_type child;
+            bool await_ready() const noexcept { return !child || child.done(); }
+            std::coroutine_handle<> await_suspend(handle_type parent) noexcept {
+                child.promise().scheduler = parent.promise().scheduler;
+                child.promise().continuation = parent;
+                return child;
+            }
+            void await_resume() const {
+                if (child && child.promise().exception) std::rethrow_exception(child.promise().exception);
+            }
+        };
+
+        handle_type handle = nullptr;
+    };
+
+    /**
+     * @brief Drives every Command from one loop at a fixed period.
+     *
+     * Each tick runs the tick hooks (odom, sensor updates...), then resumes every
+     * suspended command whose wait condition has been met, then runs the end hooks (output flushes).
+     */
+    class Scheduler {
+    public:
+        /**
+         * @brief Construct a new Scheduler object
+         *
+         * @param period the loop period in ms.
+         */
+        explicit Scheduler(std::uint32_t period = 10);
+        /**
+         * @brief Hands a command to this scheduler and starts it.
+         * The scheduler owns the command until it finishes.
+         *
+         * @param command the command to run.
+         */
+        void spawn(Command&& command);
+        /**
+         * @brief Adds a function that will run at the start of every tick, before any command is resumed.
+         * Used for things that commands depend on, like odom.compute().
+         *
+         * @param hook function to call every tick.
+         */
+        void addTickHook(std::function<void()> hook);
+        /**
+         * @brief Adds a function that will run at the end of every tick, after every command has been resumed.
+         * Used for sending what the commands decided, like MotorCommandBuffer::flush().
+         *
+         * @param hook function to call every tick.
+         */
+        void addEndHook(std::function<void()> hook);
+        /**
+         * @brief Runs a single pass: tick hooks, then every command that is ready to continue, then end hooks.
+         *
+         * @throws whatever a spawned command threw and did not catch.
+         */
+        void tick();
+        /**
+         * @brief Runs the scheduler loop until every spawned command has finished.
+         */
+        void run();
+        /**
+         * @brief Spawns the given command and runs the loop until everything has finished.
+         *
+         * @param command the command to run.
+         */
+        void run(Command&& command);
+        /**
+         * @brief Cancels every spawned command.
+         */
+        void clear();
+        /**
+         * @brief Returns if there is nothing left to run.
+         */
+        bool isIdle() const;
+        /**
+         * @brief Returns the time (ms) of the current tick.
+         */
+        std::uint32_t now() const;
+        /**
+         * @brief Returns the loop period in ms.
+         */
+        std::uint32_t getPeriod() const;
+
+        /**
+         * @brief Registers a suspended coroutine to be resumed once 'timeout' has passed or 'condition' holds.
+         * Used by the awaitables in this file, not meant to be called directly.
+         *
+         * @param h the suspended coroutine.
+         * @param timeout time (ms) after which to resume regardless of the condition, 0 with a condition waits forever.
+         * @param condition optional check that resumes the coroutine early, called with 'context'.
+         * @param context what the condition looks at, must outlive the wait.
+         */
+        void await(Command::handle_type h, std::uint32_t timeout, bool (*condition)(const void*) = nullptr, const void* context = nullptr);
+        /**
+         * @brief Unregisters a coroutine that is being destroyed while waiting.
+         *
+         * @param h the coroutine being destroyed.
+         */
+        void forget(Command::handle_type h);
+    private:
+        struct Waiter {
+            Command::handle_type handle;
+            std::uint32_t wake;
+            bool forever;
+            bool (*condition)(const void*);
+            const void* context;
+            std::uint32_t tick; // the tick this was registered on, so it is not resumed twice in one pass.
+        };
+
+        std::uint32_t period;
+        std::uint32_t current_time = 0;
+        std::uint32_t tick_count = 0;
+        std::vector<Waiter> waiters;
+        std::vector<Command> roots;
+        std::vector<std::function<void()>> hooks;
+        std::vector<std::function<void()>> end_hooks;
+    };
+
+    /**
+     * @brief Awaitable that suspends a command for a duration (or until a condition holds).
+     */
+    struct WaitAwaiter {
+        std::uint32_t duration;
+        std::function<bool()> condition;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Command::handle_type h);
+        /**
+         * @return if the condition was met (always true when there is no condition).
+         */
+        bool await_resume() const { return !condition || condition(); }
+    };
+
+    /**
+     * @brief Suspends until the next scheduler tick.
+     */
+    WaitAwaiter nextTick();
+    /**
+     * @brief Suspends for the given amount of time.
+     *
+     * @param ms time to wait in ms.
+     */
+    WaitAwaiter wait(std::uint32_t ms);
+    /**
+     * @brief Suspends until the condition is true or the timeout passes.
+     * co_await on this gives back if the condition was met.
+     *
+     * @param condition checked once per tick.
+     * @param timeout max time to wait in ms, 0 for no timeout.
+     */
+    WaitAwaiter until(std::function<bool()> condition, std::uint32_t timeout = 0);
+
+    /**
+     * @brief Runs all the commands at once, finishing when all of them have finished.
+     *
+     * @param commands the commands to run.
+     */
+    Command parallel(std::vector<Command> commands);
+    /**
+     * @brief Runs all the commands at once, finishing as soon as one of them finishes.
+     * Every other command is cancelled at that point.
+     *
+     * @param commands the commands to run.
+     */
+    Command race(std::vector<Command> commands);
+    /**
+     * @brief Runs the commands one after another.
+     *
+     * @param commands the commands to run in order.
+     */
+    Command sequence(std::vector<Command> commands);
+
+    namespace detail {
+        enum class JoinMode { All, Any };
+        /**
+         * @brief Starts every command at once and finishes when all (or any) of them have.
+         * When joining on any, the commands still running are cancelled.
+         */
+        Command join(Command* commands, std::size_t count, JoinMode mode);
+    }
+
+    // The variadic versions keep the commands in a fixed array inside the coroutine frame,
+    // so building a routine out of them does not allocate a vector.
+    template<typename... Commands>
+    Command parallel(Command first, Commands... rest) {
+        std::array<Command, 1 + sizeof...(rest)> list{std::move(first), std::move(rest)...};
+        co_await detail::join(list.data(), list.size(), detail::JoinMode::All);
+    }
+
+    template<typename... Commands>
+    Command race(Command first, Commands... rest) {
+        std::array<Command, 1 + sizeof...(rest)> list{std::move(first), std::move(rest)...};
+        co_await detail::join(list.data(), list.size(), detail::JoinMode::Any);
+    }
+
+    template<typename... Commands>
+    Command sequence(Command first, Commands... rest) {
+        std::array<Command, 1 + sizeof...(rest)> list{std::move(first), std::move(rest)...};
+        for (auto& c : list) co_await c;
+    }
+
+    /**
+     * @brief Everything the drive and turn primitives need to move the drivetrain.
+     */
+    struct MotionConfig {
+        AbstractOdom* odom;
+        PID* linear; // distance error (in) -> output
+        PID* angular; // heading error (degrees) -> output
+        std::function<void(double, double)> output; // (left, right) in [-127, 127]
+        double settleDistance = 0.5; // in inches
+        double settleAngle = 1; // in degrees
+        double maxOutput = 127;
+    };
+
+    /**
+     * @brief Drives straight for a distance, holding the heading the robot started with.
+     * The output is stopped once done or cancelled.
+     *
+     * @param config the drivetrain to drive, must outlive the command.
+     * @param inches distance to drive, negative to go backwards.
+     * @param timeout max time to spend in ms.
+     */
+    Command drive(MotionConfig& config, double inches, std::uint32_t timeout);
+    /**
+     * @brief Turns in place to face a bearing.
+     * The output is stopped once done or cancelled.
+     *
+     * @param config the drivetrain to turn, must outlive the command.
+     * @param target the bearing to face in degrees.
+     * @param timeout max time to spend in ms.
+     */
+    Command turn(MotionConfig& config, Angle target, std::uint32_t timeout);
+}
+
+#endif // COMMAND_LS_H
@@ -0,0 +1,146 @@
+/*
+* Contains the loader for small "key = value" configuration files, ex. measurements kept on the SD card.
+* A file is parsed once into a plain struct through a table of fields, with no allocation,
+* and only replaces the struct if every line and the final validation pass.
+*/
+#ifndef CONFIG_LS_H
+#define CONFIG_LS_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace ls {
+    /**
+     * @brief A list of smart ports, 0 for unused entries and negative for reversed motors.
+     * Written in a file as numbers separated by spaces or commas, ex. "left_ports = 1, 2, -3".
+     */
+    using PortList = std::array<std::int8_t, 4>;
+
+    /**
+     * @brief Gets the ports of a list that are used, ex. to build a pros::MotorGroup.
+     *
+     * @param ports the list.
+     * @return every non-zero entry, in order.
+     */
+    std::vector<std::int8_t> usedPorts(const PortList& ports);
+
+    /**
+     * @brief Maps a key in the file to a member of the config struct.
+     */
+    template<typename T>
+    struct ConfigField {
+        const char* key;
+        std::variant<float T::*, std::int8_t T::*, bool T::*, char T::*, PortList T::*> member;
+    };
+
+    /**
+     * @brief How loading a config file went.
+     */
+    enum class ConfigStatus : std::uint8_t {
+        Loaded, // the file was read and applied
+        Missing, // there is no file, the config is unchanged
+        Invalid // the file has an error, the config is unchanged
+    };
+
+    /**
+     * @brief The result of loadConfig().
+     */
+    struct ConfigResult {
+        ConfigStatus status;
+        std::uint16_t line; // line of the first error, 0 if there is none or the validation failed
+    };
+
+    /**
+     * @brief Checks a field table at compile time: every key is non-empty and used once.
+     * Meant to be used inside a static_assert.
+     *
+     * @param fields the table to check.
+     * @return if the table is valid.
+     */
+    template<typename T, std::size_t N>
+    constexpr bool validateConfigFields(const std::array<ConfigField<T>, N>& fields) {
+        for (std::size_t i = 0; i < N; i++) {
+            if (fields[i].key == nullptr || fields[i].key[0] == '\0') return false;
+            for (std::size_t j = 0; j < i; j++) {
+                std::size_t k = 0;
+                while (fields[i].key[k] != '\0' && fields[i].key[k] == fields[j].key[k]) k++;
+                if (fields[i].key[k] == fields[j].key[k]) return false;
+            }
+        }
+        return true;
+    }
+
+    namespace detail {
+        enum class LineKind : std::uint8_t { Blank, Pair, Malformed };
+
+        /**
+         * @brief Splits "key = value # comment" in place, trimming the spaces around both.
+         */
+        LineKind splitConfigLine(char* line, char*& key, char*& value);
+
+        bool parseConfigValue(const char* text, float& out);
+        bool parseConfigValue(const char* text, std::int8_t& out);
+        bool parseConfigValue(const char* text, bool& out);
+        bool parseConfigValue(const char* text, char& out);
+        bool parseConfigValue(const char* text, PortList& out);
+    }
+
+    /**
+     * @brief Reads a config file into 'config'.
+     * Keys not in the file keep their current values, so 'config' should hold the defaults beforehand.
+     * Unknown keys, bad values and lines over 127 characters (not counting the "\n" or "\r\n") make the file invalid.
+     *
+     * @param path the file to read, ex. "/usd/robot.cfg".
+     * @param fields every key the file may contain.
+     * @param validate checks the whole config after parsing (ranges, conflicts), nullptr to skip.
+     * Not used to deduce T, so nullptr can be passed as is.
+     * @param config the config to fill, only changed when the result is ConfigStatus::Loaded.
+     * @return if the file was loaded, and where it failed if not.
+     */
+    template<typename T, std::size_t N>
+    ConfigResult loadConfig(const char* path, const std::array<ConfigField<T>, N>& fields, std::type_identity_t<bool (*)(const T&)> validate, T& config) {
+        std::FILE* file = std::fopen(path, "r");
+        if (file == nullptr) return {ConfigStatus::Missing, 0};
+
+        T loaded = config;
+        char buffer[130]; // 127 characters, "\r\n" and the terminator
+        std::uint16_t line = 0;
+        ConfigResult result{ConfigStatus::Loaded, 0};
+        while (result.status == ConfigStatus::Loaded && std::fgets(buffer, sizeof(buffer), file) != nullptr) {
+            line++;
+            // too long: fgets cut it, or text took the room kept for "\r\n".
+            if ((std::strchr(buffer, '\n') == nullptr && !std::feof(file)) || std::strcspn(buffer, "\r\n") > 127) {
+                result = {ConfigStatus::Invalid, line};
+                break;
+            }
+            char* key;
+            char* value;
+            const detail::LineKind kind = detail::splitConfigLine(buffer, key, value);
+            if (kind == detail::LineKind::Blank) continue;
+
+            bool parsed = false;
+            if (kind == detail::LineKind::Pair) {
+                for (const ConfigField<T>& field : fields) {
+                    if (std::strcmp(field.key, key) != 0) continue;
+                    parsed = std::visit([&](auto member) { return detail::parseConfigValue(value, loaded.*member); }, field.member);
+                    break;
+                }
+            }
+            if (!parsed) result = {ConfigStatus::Invalid, line};
+        }
+        std::fclose(file);
+
+        if (result.status == ConfigStatus::Loaded && validate != nullptr && !validate(loaded)) {
+            result = {ConfigStatus::Invalid, 0};
+        }
+        if (result.status == ConfigStatus::Loaded) config = loaded;
+        return result;
+    }
+}
+
+#endif // CONFIG_LS_H
@@ -0,0 +1,112 @@
+/*
+* Contains the controller screen and rumble queue.
+* The radio only takes one controller update about every 50ms, so writes are queued here,
+* merged, and sent by a background task at that rate instead of blocking (or being dropped by) the control loop.
+*/
+#ifndef CONTROLLERDISPLAY_LS_H
+#define CONTROLLERDISPLAY_LS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Owns the three text lines and the rumble of one controller.
+     *
+     * setLine(), print() and rumble() only copy into a pending buffer and return, so they are safe to call every tick.
+     * A newer write to a line replaces an unsent older one, and a line is only sent if it differs from what the screen shows.
+     * The task sends one update per period: a pending rumble first, then changed lines in turn.
+     */
+    class ControllerDisplay {
+        public:
+            static constexpr std::uint8_t LINES = 3;
+            static constexpr std::uint8_t WIDTH = 15; // characters per line
+            static constexpr std::uint8_t MAX_RUMBLE = 8; // characters in a rumble pattern
+
+            /**
+             * @brief Construct a new Controller Display object
+             *
+             * @param controller the controller to write to.
+             * @param period time in ms between updates, the radio needs ~50.
+             */
+            explicit ControllerDisplay(pros::controller_id_e_t controller = pros::E_CONTROLLER_MASTER, std::uint32_t period = 50);
+            ~ControllerDisplay();
+
+            /**
+             * @brief Sets the text of a line, cut or padded to WIDTH characters.
+             *
+             * @param line the line [0, 2].
+             * @param text the text.
+             * @throws std::out_of_range if the line does not exist.
+             */
+            void setLine(std::uint8_t line, const char* text);
+
+            /**
+             * @brief Sets the text of a line from a printf style format.
+             *
+             * @param line the line [0, 2].
+             * @param format the format, ex. "Batt %d%%".
+             * @throws std::out_of_range if the line does not exist.
+             */
+            void print(std::uint8_t line, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+            /**
+             * @brief Blanks every line, without the blocking pros::Controller::clear().
+             */
+            void clear();
+
+            /**
+             * @brief Queues a rumble, replacing one that has not been sent yet.
+             *
+             * @param pattern '.' short, '-' long and ' ' pause, cut to MAX_RUMBLE characters.
+             */
+            void rumble(const char* pattern);
+
+            /**
+             * @brief Starts the task that sends the updates, at the lowest priority above idle.
+             */
+            void start();
+
+            /**
+             * @brief Stops the task, unsent updates stay queued.
+             */
+            void stop();
+
+            /**
+             * @brief Gets the number of updates sent to the controller.
+             */
+            std::uint32_t getWrites() const;
+
+            /**
+             * @brief Gets the number of writes that were replaced or skipped (unchanged) before they had to be sent.
+             */
+            std::uint32_t getMerged() const;
+        private:
+            using Line = std::array<char, WIDTH + 1>;
+
+            void loop();
+            bool sendNext();
+
+            pros::Controller controller;
+            std::uint32_t period;
+
+            std::array<Line, LINES> pending{};
+            std::array<Line, LINES> shown{};
+            std::uint8_t dirty = 0; // bit i is set while line i differs from what is shown
+            std::uint8_t nextLine = 0;
+            std::array<char, MAX_RUMBLE + 1> rumblePattern{};
+            bool rumblePending = false;
+
+            std::atomic<std::uint32_t> writes = 0;
+            std::atomic<std::uint32_t> merged = 0;
+
+            pros::Mutex mutex;
+            std::unique_ptr<pros::Task> task = nullptr;
+            std::atomic<bool> running = false;
+    };
+}
+
+#endif // CONTROLLERDISPLAY_LS_H
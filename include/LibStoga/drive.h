@@ -0,0 +1,173 @@
+/*
+* Contains the joystick shaping and drive mixing used by driver control.
+* Curves are baked into lookup tables once, so a drive tick is a table read and a few multiplies.
+*/
+#ifndef DRIVE_LS_H
+#define DRIVE_LS_H
+
+#include <array>
+#include <cstdint>
+
+namespace ls {
+    /**
+     * @brief The shape of a joystick curve.
+     */
+    enum class CurveType : std::uint8_t {
+        Linear, // output = input
+        Cubic, // output = (1 - gain) * input + gain * input^3, gain in [0, 1]
+        Exponential // output = (e^(gain * |input|) - 1) / (e^gain - 1), gain > 0
+    };
+
+    /**
+     * @brief Maps a raw joystick value [-127, 127] to a power in [-1, 1] through a 256 entry table.
+     * The deadband is applied first and the rest of the stick travel is stretched back to the full range,
+     * so the curve still starts at 0 and ends at 1.
+     */
+    class JoystickCurve {
+        public:
+            /**
+             * @brief Construct a new Joystick Curve object, computing the table.
+             *
+             * @param type the shape of the curve.
+             * @param gain how strong the curve is (see CurveType), ignored for Linear.
+             * @param deadband raw joystick values with a magnitude up to this are 0, [0, 127).
+             * @throws std::invalid_argument if the deadband or gain are out of range.
+             */
+            explicit JoystickCurve(CurveType type = CurveType::Linear, float gain = 0, std::uint8_t deadband = 0);
+
+            /**
+             * @brief Looks up the power for a raw joystick value.
+             * @param raw the joystick value, clamped to [-127, 127].
+             * @return the power in [-1, 1].
+             */
+            float operator()(std::int32_t raw) const {
+                if (raw > 127) raw = 127;
+                if (raw < -127) raw = -127;
+                return table[static_cast<std::uint8_t>(raw + 128)];
+            }
+        private:
+            std::array<float, 256> table{}; // index is raw + 128
+    };
+
+    /**
+     * @brief Scales both sides down together if either is past full power, keeping the ratio between them (and so the turn).
+     *
+     * @param left left side power, scaled in place.
+     * @param right right side power, scaled in place.
+     * @param limit the largest magnitude allowed.
+     */
+    inline void desaturate(float& left, float& right, float limit = 1) {
+        const float absLeft = left < 0 ? -left : left;
+        const float absRight = right < 0 ? -right : right;
+        const float largest = absLeft > absRight ? absLeft : absRight;
+        if (largest > limit) {
+            const float scale = limit / largest;
+            left *= scale;
+            right *= scale;
+        }
+    }
+
+    /**
+     * @brief Limits how fast a power command can change, with separate limits for speeding up and slowing down.
+     * Speeding up too fast spins the wheels and browns out the battery, slowing down can usually be quicker.
+     */
+    class SlewLimiter {
+        public:
+            /**
+             * @brief Construct a new Slew Limiter object
+             *
+             * @param accelRate largest increase in |power| per second (power is [-1, 1]).
+             * @param decelRate largest decrease in |power| per second.
+             * @throws std::invalid_argument if a rate is not positive.
+             */
+            explicit SlewLimiter(float accelRate = 4, float decelRate = 10);
+
+            /**
+             * @brief Moves the output towards the target as far as the limits allow.
+             * Crossing zero slows down to zero first (decel limit) and then speeds up (accel limit).
+             *
+             * @param target the wanted power.
+             * @param dt time since the last update in seconds.
+             * @return the limited power.
+             */
+            float update(float target, float dt);
+
+            /**
+             * @brief Sets the output without limiting, ex. after a brake.
+             * @param value the new output.
+             */
+            void reset(float value = 0);
+
+            /**
+             * @brief Gets the last output.
+             */
+            float get() const;
+        private:
+            float accelRate;
+            float decelRate;
+            float value = 0;
+    };
+
+    /**
+     * @brief Settings for TractionControl.
+     */
+    struct TractionConfig {
+        float slipRatio = 0.2f; // slipping when the wheels are this much faster than the ground (fraction of wheel speed)
+        float minSpeed = 2; // in in/s, below this wheel speed slip is not checked
+        float currentThreshold = 1800; // in mA, slip only counts while the motors are pushing this hard
+        float backoff = 0.1f; // scale taken away per update while slipping
+        float recovery = 0.05f; // scale given back per update while gripping
+        float minScale = 0.4f;
+    };
+
+    /**
+     * @brief Backs off a side's power when its wheels spin faster than the robot is actually moving.
+     * Compares the wheel speed (motor encoders) with the ground speed (tracking wheels), a few multiplies per update.
+     */
+    class TractionControl {
+        public:
+            /**
+             * @brief Construct a new Traction Control object
+             * @param config the thresholds and rates.
+             */
+            explicit TractionControl(TractionConfig config = {});
+
+            /**
+             * @brief Checks for slip and adjusts the scale, call once per tick with fresh measurements.
+             *
+             * @param wheelSpeed speed of the driven wheels from the motor encoders, in in/s.
+             * @param groundSpeed speed of that side over the ground from the tracking wheels, in in/s.
+             * @param current current drawn by the side's motors, in mA.
+             */
+            void update(float wheelSpeed, float groundSpeed, float current);
+
+            /**
+             * @brief Scales a power command by the current traction scale.
+             * @param command the power.
+             */
+            float apply(float command) const {
+                return command * scale;
+            }
+
+            /**
+             * @brief Gets the current scale, 1 when gripping.
+             */
+            float getScale() const;
+
+            /**
+             * @brief Returns if the last update detected slip.
+             */
+            bool isSlipping() const;
+
+            /**
+             * @brief Back to full power and no slip.
+             */
+            void reset();
+        private:
+            TractionConfig config;
+            float scale = 1;
+            bool slipping = false;
+    };
+}
+
+#endif // DRIVE_LS_H
@@ -0,0 +1,205 @@
+/*
+* Contains fast, bounded error replacements for the libm trig functions that odom and path following call every tick.
+* Everything is inline and branch-light so the batch versions can be vectorized (float on NEON).
+*
+* Odom and geometry use these instead of libm when built with -DLS_USE_FASTMATH (see Numeric in numeric.h).
+*
+* The max errors below are checked against libm by test/fastmath_bench.cpp, which also times both.
+* newlib's double sin/atan2 on the V5 are much slower than the glibc ones it is timed against on a computer.
+*/
+#ifndef FASTMATH_LS_H
+#define FASTMATH_LS_H
+
+#include <cmath>
+#include <cstddef>
+#include "geometry.h"
+
+namespace ls::fastmath {
+    namespace detail {
+        // 2pi split in two so the range reduction keeps precision for larger angles.
+        constexpr double TAU_HI = 6.28318530717958623200;
+        constexpr double TAU_LO = 2.44929359829470635445e-16;
+        constexpr double INV_TAU = 1.0 / TAU;
+        constexpr double HALF_PI = PI / 2;
+        constexpr double TAN_PI_8 = 0.41421356237309504880;
+
+        /**
+         * @brief Minimax odd polynomial for sin(x) on [-pi/2, pi/2], max error 3.4e-9.
+         */
+        template<typename T>
+        constexpr T sinPoly(T x) {
+            const T x2 = x * x;
+            return x * (T(0.99999997658988227) + x2 * (T(-0.16666647634639789) + x2 * (T(0.0083328998233526391)
+                + x2 * (T(-0.00019800897762841334) + x2 * T(2.5904885006214772e-06)))));
+        }
+
+        /**
+         * @brief Minimax even polynomial for cos(x) on [-pi/2, pi/2], max error 2.2e-10.
+         */
+        template<typename T>
+        constexpr T cosPoly(T x) {
+            const T x2 = x * x;
+            return T(0.99999999978065168) + x2 * (T(-0.49999999358471758) + x2 * (T(0.041666636258070461)
+                + x2 * (T(-0.0013888361400280467) + x2 * (T(2.4760161352910603e-05) + x2 * T(-2.6051495221431306e-07)))));
+        }
+
+        /**
+         * @brief Minimax odd polynomial for atan(x) on [-tan(pi/8), tan(pi/8)], max error 1.2e-10.
+         */
+        template<typename T>
+        constexpr T atanPoly(T x) {
+            const T x2 = x * x;
+            return x * (T(0.99999999627054492) + x2 * (T(-0.33333271105697754) + x2 * (T(0.19997023126377916)
+                + x2 * (T(-0.14224160572058886) + x2 * (T(0.10480594857933699) + x2 * T(-0.058377884811058094))))));
+        }
+
+        /**
+         * @brief Reduces x into [-pi/2, pi/2], giving the sign cos has to be flipped by.
+         * Uses a float to int conversion instead of floor() since the Cortex-A9 has no rounding instruction.
+         * Valid for |x| < 1e9.
+         */
+        template<typename T>
+        inline T reduce(T x, T& cosSign) {
+            const T scaled = x * T(INV_TAU);
+            const T k = static_cast<T>(static_cast<long>(scaled + (scaled >= 0 ? T(0.5) : T(-0.5))));
+            const T r = (x - k * T(TAU_HI)) - k * T(TAU_LO); // now in [-pi, pi]
+            // sin(pi - r) = sin(r) and cos(pi - r) = -cos(r)
+            const bool high = r > T(HALF_PI);
+            const bool low = r < T(-HALF_PI);
+            cosSign = (high || low) ? T(-1) : T(1);
+            return high ? T(PI) - r : (low ? T(-PI) - r : r);
+        }
+    }
+
+    /**
+     * @brief sin(x), max error 3.4e-9 for |x| < 1e3 (double), 2.2e-7 for |x| < 2pi (float).
+     * float error past 2pi grows with the spacing of floats around x.
+     */
+    template<typename T>
+    inline T sin(T x) {
+        T cosSign;
+        return detail::sinPoly(detail::reduce(x, cosSign));
+    }
+
+    /**
+     * @brief cos(x), max error 2.2e-10 for |x| < 1e3 (double), 3.0e-7 for |x| < 2pi (float).
+     */
+    template<typename T>
+    inline T cos(T x) {
+        T cosSign;
+        const T r = detail::reduce(x, cosSign);
+        return cosSign * detail::cosPoly(r);
+    }
+
+    /**
+     * @brief sin(x) and cos(x) together, sharing one range reduction.
+     *
+     * @param x the angle in radians.
+     * @param s where sin(x) is written.
+     * @param c where cos(x) is written.
+     */
+    template<typename T>
+    inline void sincos(T x, T& s, T& c) {
+        T cosSign;
+        const T r = detail::reduce(x, cosSign);
+        s = detail::sinPoly(r);
+        c = cosSign * detail::cosPoly(r);
+    }
+
+    /**
+     * @brief atan2(y, x) in (-pi, pi], max error 1.2e-10 (double), 2.8e-7 (float).
+     * Returns 0 for atan2(0, 0).
+     */
+    template<typename T>
+    inline T atan2(T y, T x) {
+        const T ax = x < 0 ? -x : x;
+        const T ay = y < 0 ? -y : y;
+        const T high = ax > ay ? ax : ay;
+        const T low = ax > ay ? ay : ax;
+        if (high == T(0)) return T(0);
+
+        const T t = low / high; // [0, 1]
+        // atan(t) = pi/4 + atan((t - 1) / (t + 1)) keeps the polynomial's input inside [-tan(pi/8), tan(pi/8)].
+        const bool shifted = t > T(detail::TAN_PI_8);
+        const T u = shifted ? (t - T(1)) / (t + T(1)) : t;
+        T angle = detail::atanPoly(u) + (shifted ? T(PI / 4) : T(0));
+
+        angle = ay > ax ? T(detail::HALF_PI) - angle : angle;
+        angle = x < 0 ? T(PI) - angle : angle;
+        return y < 0 ? -angle : angle;
+    }
+
+    /**
+     * @brief sqrt(x*x + y*y) without libm's overflow/underflow handling (a single VFP sqrt).
+     * Only overflows for values past ~1e154, which odom will never see.
+     */
+    template<typename T>
+    inline T hypot(T x, T y) {
+        return std::sqrt(x * x + y * y);
+    }
+
+    /**
+     * @brief Batch sin over an array.
+     *
+     * @param in the angles in radians.
+     * @param out where the results are written, can be the same as 'in'.
+     * @param count number of elements.
+     */
+    template<typename T>
+    inline void sin(const T* in, T* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) out[i] = sin(in[i]);
+    }
+
+    /**
+     * @brief Batch cos over an array.
+     *
+     * @param in the angles in radians.
+     * @param out where the results are written, can be the same as 'in'.
+     * @param count number of elements.
+     */
+    template<typename T>
+    inline void cos(const T* in, T* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) out[i] = cos(in[i]);
+    }
+
+    /**
+     * @brief Batch sincos over an array.
+     *
+     * @param in the angles in radians.
+     * @param s where the sines are written.
+     * @param c where the cosines are written.
+     * @param count number of elements.
+     */
+    template<typename T>
+    inline void sincos(const T* in, T* s, T* c, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) sincos(in[i], s[i], c[i]);
+    }
+
+    /**
+     * @brief Batch atan2 over two arrays.
+     *
+     * @param y the y values.
+     * @param x the x values.
+     * @param out where the results are written.
+     * @param count number of elements.
+     */
+    template<typename T>
+    inline void atan2(const T* y, const T* x, T* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) out[i] = atan2(y[i], x[i]);
+    }
+
+    /**
+     * @brief Batch hypot over two arrays.
+     *
+     * @param x the x values.
+     * @param y the y values.
+     * @param out where the results are written.
+     * @param count number of elements.
+     */
+    template<typename T>
+    inline void hypot(const T* x, const T* y, T* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) out[i] = hypot(x[i], y[i]);
+    }
+}
+
+#endif // FASTMATH_LS_H
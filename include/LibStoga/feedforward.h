@@ -0,0 +1,132 @@
+/*
+* Contains the drivetrain and arm feedforward models and the least squares fit used to characterize the drivetrain.
+* Nothing here touches PROS devices, so the fit also builds on a computer to refit logged runs.
+*/
+#ifndef FEEDFORWARD_LS_H
+#define FEEDFORWARD_LS_H
+
+#include <cmath>
+#include <cstddef>
+
+namespace ls {
+    /**
+     * @brief voltage = kS * sign(velocity) + kV * velocity + kA * acceleration.
+     * Units follow whatever the fit was given, ex. volts per (in/s) for a linear drive or per (rad/s) for turning.
+     */
+    struct FeedforwardGains {
+        double kS = 0;
+        double kV = 0;
+        double kA = 0;
+
+        /**
+         * @brief Computes the voltage for the given motion.
+         *
+         * @param velocity the wanted velocity.
+         * @param acceleration the wanted acceleration.
+         * @return the voltage.
+         */
+        double calculate(double velocity, double acceleration = 0) const {
+            const double sign = velocity > 0 ? 1 : (velocity < 0 ? -1 : 0);
+            return kS * sign + kV * velocity + kA * acceleration;
+        }
+    };
+
+    /**
+     * @brief voltage = kS * sign(velocity) + kG * cos(angle) + kV * velocity + kA * acceleration.
+     * For a mechanism that rotates against gravity, with the angle measured from horizontal:
+     * holding it level takes the most voltage (kG) and holding it straight up or down takes none.
+     */
+    struct ArmFeedforward {
+        double kS = 0;
+        double kG = 0;
+        double kV = 0;
+        double kA = 0;
+
+        /**
+         * @brief Computes the voltage for the given motion.
+         *
+         * @param angle the angle from horizontal, in radians.
+         * @param velocity the wanted velocity.
+         * @param acceleration the wanted acceleration.
+         * @return the voltage.
+         */
+        double calculate(double angle, double velocity, double acceleration = 0) const {
+            const double sign = velocity > 0 ? 1 : (velocity < 0 ? -1 : 0);
+            return kS * sign + kG * std::cos(angle) + kV * velocity + kA * acceleration;
+        }
+    };
+
+    /**
+     * @brief Fits FeedforwardGains to (voltage, velocity, acceleration) samples by ordinary least squares.
+     * Only the 3x3 normal equations are kept, so any number of samples costs the same memory.
+     */
+    class FeedforwardFit {
+        public:
+            /**
+             * @brief Construct a new Feedforward Fit object
+             *
+             * @param minVelocity samples slower than this are skipped, static friction makes them unreliable.
+             */
+            explicit FeedforwardFit(double minVelocity = 0);
+
+            /**
+             * @brief Adds one sample.
+             *
+             * @param voltage the voltage applied.
+             * @param velocity the measured velocity.
+             * @param acceleration the measured acceleration.
+             */
+            void add(double voltage, double velocity, double acceleration);
+
+            /**
+             * @brief Solves for the gains that fit every sample so far best.
+             *
+             * @return the gains, all 0 if the samples cannot tell the terms apart (ex. only one kind of run).
+             */
+            FeedforwardGains solve() const;
+
+            /**
+             * @brief Gets how much of the voltage the fitted gains explain, 1 is a perfect fit.
+             */
+            double getRSquared() const;
+
+            /**
+             * @brief Gets the number of samples used.
+             */
+            std::size_t getCount() const;
+
+            /**
+             * @brief Removes every sample.
+             */
+            void reset();
+        private:
+            double minVelocity;
+            double xtx[3][3] = {}; // sum of x * x^T, x = (sign(v), v, a)
+            double xty[3] = {}; // sum of x * voltage
+            double sumY = 0;
+            double sumYY = 0;
+            std::size_t count = 0;
+    };
+
+    /**
+     * @brief Writes linear and angular gains to a file (ex. on the SD card, "/usd/feedforward.txt").
+     *
+     * @param path the file to write.
+     * @param linear the linear gains.
+     * @param angular the angular gains.
+     * @return if the file was written.
+     */
+    bool saveFeedforward(const char* path, const FeedforwardGains& linear, const FeedforwardGains& angular);
+
+    /**
+     * @brief Reads linear and angular gains written by saveFeedforward(). Leaves them unchanged if the file is missing or bad.
+     *
+     * @param path the file to read.
+     * @param linear where the linear gains are written.
+     * @param angular where the angular gains are written.
+     * @return if the gains were read.
+     */
+    bool loadFeedforward(const char* path, FeedforwardGains& linear, FeedforwardGains& angular);
+}
+
+#endif // FEEDFORWARD_LS_H
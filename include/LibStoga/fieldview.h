@@ -0,0 +1,221 @@
+/*
+* Contains the brain screen field view: the field, the robot pose, a path and a target, drawn by a low priority task.
+* Only the rectangles that changed since the last frame are redrawn, so a moving robot costs a few
+* thousand pixels a frame instead of the whole field.
+*/
+#ifndef FIELDVIEW_LS_H
+#define FIELDVIEW_LS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "api.h"
+#include "odom.h"
+
+namespace ls {
+    /**
+     * @brief A rectangle of screen pixels, both corners included.
+     */
+    struct ScreenRect {
+        std::int16_t x0 = 0;
+        std::int16_t y0 = 0;
+        std::int16_t x1 = -1;
+        std::int16_t y1 = -1;
+
+        constexpr bool empty() const {
+            return x1 < x0 || y1 < y0;
+        }
+
+        constexpr std::int32_t area() const {
+            return empty() ? 0 : static_cast<std::int32_t>(x1 - x0 + 1) * (y1 - y0 + 1);
+        }
+
+        constexpr bool intersects(const ScreenRect& other) const {
+            return !empty() && !other.empty() && x0 <= other.x1 && other.x0 <= x1 && y0 <= other.y1 && other.y0 <= y1;
+        }
+
+        /**
+         * @brief Gets the smallest rectangle holding both.
+         */
+        constexpr ScreenRect merge(const ScreenRect& other) const {
+            if (empty()) return other;
+            if (other.empty()) return *this;
+            return {x0 < other.x0 ? x0 : other.x0, y0 < other.y0 ? y0 : other.y0,
+                x1 > other.x1 ? x1 : other.x1, y1 > other.y1 ? y1 : other.y1};
+        }
+
+        /**
+         * @brief Gets the part inside 'bounds'.
+         */
+        constexpr ScreenRect clip(const ScreenRect& bounds) const {
+            return {x0 > bounds.x0 ? x0 : bounds.x0, y0 > bounds.y0 ? y0 : bounds.y0,
+                x1 < bounds.x1 ? x1 : bounds.x1, y1 < bounds.y1 ? y1 : bounds.y1};
+        }
+    };
+
+    /**
+     * @brief A fixed list of screen rectangles that need redrawing.
+     * Overlapping rectangles are merged, and once the list is full a new one is merged into
+     * the rectangle it grows the least, so the list never allocates.
+     */
+    class DirtyRegions {
+        public:
+            static constexpr std::size_t MAX_RECTS = 8;
+
+            /**
+             * @brief Marks a rectangle as needing a redraw.
+             * @param rect the rectangle, ignored if empty.
+             */
+            void add(ScreenRect rect);
+
+            /**
+             * @brief Removes every rectangle.
+             */
+            void clear();
+
+            /**
+             * @brief Gets the number of rectangles.
+             */
+            std::size_t size() const;
+
+            /**
+             * @brief Gets the total area of the rectangles, in pixels.
+             */
+            std::int32_t area() const;
+
+            const ScreenRect* begin() const { return rects.data(); }
+            const ScreenRect* end() const { return rects.data() + count; }
+        private:
+            std::array<ScreenRect, MAX_RECTS> rects{};
+            std::size_t count = 0;
+    };
+
+    /**
+     * @brief Draws the field on the left 240x240 pixels of the brain screen and the pose as text on the right.
+     *
+     * The control loop only hands over values (setPose(), setTarget(), setPath()), which copies them under a mutex.
+     * A task at the lowest priority above idle draws them, about 20 times a second.
+     */
+    class FieldView {
+        public:
+            static constexpr std::int16_t FIELD_PIXELS = 240;
+            static constexpr double FIELD_INCHES = 144;
+            static constexpr std::size_t MAX_PATH = 64;
+
+            /**
+             * @brief Construct a new Field View object
+             *
+             * @param startX where odom's (0, 0) is on the field, in inches from the left wall.
+             * @param startY where odom's (0, 0) is on the field, in inches from the bottom wall.
+             * @param robotSize length of the robot's sides in inches.
+             * @param period time in ms between frames.
+             */
+            explicit FieldView(double startX = FIELD_INCHES / 2, double startY = FIELD_INCHES / 2, double robotSize = 15, std::uint32_t period = 50);
+            ~FieldView();
+
+            /**
+             * @brief Sets the robot's pose, ex. odom.getPosition() once per tick.
+             */
+            void setPose(const Position& pose);
+
+            /**
+             * @brief Shows a target point, in odom coordinates (inches).
+             */
+            void setTarget(double x, double y);
+
+            /**
+             * @brief Hides the target point.
+             */
+            void clearTarget();
+
+            /**
+             * @brief Shows a path, in odom coordinates. Only the first MAX_PATH points are kept.
+             */
+            void setPath(std::span<const Position> points);
+
+            /**
+             * @brief Hides the path.
+             */
+            void clearPath();
+
+            /**
+             * @brief Redraws everything on the next frame, ex. after something else drew on the screen.
+             */
+            void invalidate();
+
+            /**
+             * @brief Starts the drawing task, with a full redraw.
+             */
+            void start();
+
+            /**
+             * @brief Stops the drawing task.
+             */
+            void stop();
+
+            /**
+             * @brief Gets the number of frames that drew anything.
+             */
+            std::uint32_t getFrames() const;
+
+            /**
+             * @brief Gets the number of field pixels redrawn over all frames.
+             */
+            std::uint64_t getRedrawnPixels() const;
+        private:
+            struct Point {
+                std::int16_t x;
+                std::int16_t y;
+            };
+
+            struct Scene {
+                std::array<Point, 5> robot; // 4 corners and the front center
+                Point center;
+                bool hasTarget;
+                Point target;
+                std::array<Point, MAX_PATH> path;
+                std::size_t pathSize;
+            };
+
+            void loop();
+            void frame();
+            void draw(const Scene& scene, const ScreenRect& clip) const;
+            void drawText(const Position& pose);
+            Point toScreen(double x, double y) const;
+            static ScreenRect robotBounds(const Scene& scene);
+            static ScreenRect pathBounds(const Scene& scene);
+            static ScreenRect targetBounds(const Scene& scene);
+
+            double startX;
+            double startY;
+            double robotSize;
+            std::uint32_t period;
+
+            // written by the setters, under the mutex.
+            Position pose;
+            bool hasTarget = false;
+            double targetX = 0;
+            double targetY = 0;
+            std::array<Position, MAX_PATH> path;
+            std::size_t pathSize = 0;
+            bool pathChanged = true;
+            bool fullRedraw = true;
+
+            // only used by the task.
+            Scene drawn{};
+            DirtyRegions dirty;
+            std::array<std::int16_t, 3> shownText{-32768, -32768, -32768}; // X, Y (tenths of an inch) and heading (degrees)
+
+            std::atomic<std::uint32_t> frames = 0;
+            std::atomic<std::uint64_t> pixels = 0;
+
+            pros::Mutex mutex;
+            std::unique_ptr<pros::Task> task = nullptr;
+            std::atomic<bool> running = false;
+    };
+}
+
+#endif // FIELDVIEW_LS_H
@@ -1,91 +1,209 @@
 #ifndef GEOMETRY_LS_H
 #define GEOMETRY_LS_H
 
+#include <cmath>
+#include <type_traits>
 
 namespace ls {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double TAU = 2 * PI;
+    constexpr double DEG_TO_RAD = PI / 180.0;
+    constexpr double RAD_TO_DEG = 180.0 / PI;
+
+    /**
+     * @brief The range an angle gets wrapped into.
+     */
+    enum class AngleWrap {
+        Positive, // [0, 2pi), or [0, 360) in degrees
+        Signed // [-pi, pi), or [-180, 180) in degrees
+    };
+
+    namespace detail {
+        /**
+         * @brief floor() that can also run at compile time.
+         */
+        constexpr double floor(double x) {
+            if (std::is_constant_evaluated()) {
+                const double truncated = static_cast<double>(static_cast<long long>(x));
+                return truncated > x ? truncated - 1 : truncated;
+            }
+            return std::floor(x);
+        }
+    }
+
+    /**
+     * @brief Wraps an angle in radians into the given range.
+     * Constant time no matter how far the value has drifted (uses fmod/remainder, never loops).
+     *
+     * @param radians the angle to wrap.
+     * @param wrap the range to wrap into.
+     * @return the wrapped angle in radians.
+     */
+    constexpr double wrapRadians(double radians, AngleWrap wrap) {
+        double wrapped;
+        if (std::is_constant_evaluated()) {
+            const double offset = wrap == AngleWrap::Signed ? PI : 0;
+            wrapped = radians - TAU * detail::floor((radians + offset) / TAU);
+        } else if (wrap == AngleWrap::Signed) {
+            wrapped = std::remainder(radians, TAU);
+        } else {
+            wrapped = std::fmod(radians, TAU);
+            if (wrapped < 0) wrapped += TAU;
+        }
+        // rounding can land exactly on the open end of the range.
+        if (wrap == AngleWrap::Signed) return wrapped >= PI ? wrapped - TAU : wrapped;
+        return wrapped >= TAU ? wrapped - TAU : wrapped;
+    }
+
+    /**
+     * @brief Converts a given angle in degrees to radians.
+     * @param degrees The angle in degrees to be converted.
+     * @return The angle in radians.
+     */
+    constexpr double degreesToRadians(double degrees) {
+        return degrees * DEG_TO_RAD;
+    }
+
+    /**
+     * @brief Converts the current angle from radians to degrees.
+     * @param radians The angle in radians to be converted.
+     * @return The angle in degrees.
+     */
+    constexpr double radiansToDegrees(double radians) {
+        return radians * RAD_TO_DEG;
+    }
+
     /**
      * @class Angle
      * @brief A class to represent and manipulate angles.
+     *
+     * Stored in radians so trig calls need no conversion, everything is constexpr.
+     * The double constructor and the get/set methods still work in degrees.
      */
     class Angle {
         private:
-            double angle;
+            double angle; // in radians
+
+            struct RadiansTag {};
+            constexpr Angle(double radians, RadiansTag): angle(radians) {}
         public:
             /**
              * @brief Default constructor initializes the angle to 0 degrees.
              */
-            Angle(): angle(0) {}
-
+            constexpr Angle(): angle(0) {}
             /**
              * @brief Parameterized constructor initializes the angle to the given value.
              * @param a The initial value of the angle in degrees.
              */
-            Angle(double a): angle(a) {}
+            constexpr Angle(double a): angle(degreesToRadians(a)) {}
+            /**
+             * @brief Makes an angle from a value in radians.
+             * @param radians the angle in radians.
+             */
+            static constexpr Angle fromRadians(double radians) {
+                return Angle(radians, RadiansTag{});
+            }
+            /**
+             * @brief Makes an angle from a value in degrees.
+             * @param degrees the angle in degrees.
+             */
+            static constexpr Angle fromDegrees(double degrees) {
+                return Angle(degrees);
+            }
 
             /**
              * @brief Sets the angle to the specified value.
              * @param val The new value of the angle in degrees.
              */
-            void setAngle(double val);
-
+            constexpr void setAngle(double val) {
+                angle = degreesToRadians(val);
+            }
             /**
              * @brief Returns the current value of the angle.
              * @return The current angle in degrees.
              */
-            double getAngle() const;
-
+            constexpr double getAngle() const {
+                return radiansToDegrees(angle);
+            }
             /**
-             * @brief Converts the angle from degrees to radians.
+             * @brief Returns the angle in radians.
              * @return The angle in radians.
              */
-            double convertToRadians() const;
-
+            constexpr double convertToRadians() const {
+                return angle;
+            }
             /**
              * @brief Normalizes the angle to be within the range [0, 360) degrees.
              * @return The normalized angle in degrees.
              */
-            double normalize() const;
-
+            constexpr double normalize() const {
+                return radiansToDegrees(wrapRadians(angle, AngleWrap::Positive));
+            }
+            /**
+             * @brief Returns this angle wrapped into the given range.
+             * @param wrap the range to wrap into.
+             * @return the wrapped angle.
+             */
+            constexpr Angle wrapped(AngleWrap wrap) const {
+                return fromRadians(wrapRadians(angle, wrap));
+            }
             /**
              * @brief returns the MINIMUM difference between this angle and the given angle.
-             * this difference will have a range of [-180, 180] and is most useful for finding
+             * this difference will have a range of [-180, 180) and is most useful for finding
              * the error for turn PID.
-             * 
+             *
              * @param angle the angle to compare
              * @return the angle difference.
              */
-            Angle minimumAngleDifference(Angle& angle) const; 
-
+            constexpr Angle minimumAngleDifference(const Angle& other) const {
+                return fromRadians(wrapRadians(angle - other.angle, AngleWrap::Signed));
+            }
+            /**
+             * @brief Converts a bearing (0 is north, clockwise) into a math angle (0 is east, counter-clockwise).
+             * @return the same direction as a math angle.
+             */
+            constexpr Angle toMath() const {
+                return fromRadians(PI / 2 - angle);
+            }
+            /**
+             * @brief Converts a math angle (0 is east, counter-clockwise) into a bearing (0 is north, clockwise).
+             * @return the same direction as a bearing.
+             */
+            constexpr Angle toBearing() const {
+                return fromRadians(PI / 2 - angle);
+            }
             /**
              * @brief Another way to use the setAngle() method.
-             * 
+             *
              * @param x the new value of this angle.
              */
-            void operator=(double x);
-            
+            constexpr void operator=(double x) {
+                setAngle(x);
+            }
             /**
              * @brief increemnts this angle by 'other' angle numricaly.
-             * 
+             *
              * @param other the other angle to increment by.
              */
-            void operator+=(Angle other);
+            constexpr void operator+=(Angle other) {
+                angle += other.angle;
+            }
+            constexpr void operator-=(Angle other) {
+                angle -= other.angle;
+            }
+            constexpr Angle operator+(Angle other) const {
+                return fromRadians(angle + other.angle);
+            }
+            constexpr Angle operator-(Angle other) const {
+                return fromRadians(angle - other.angle);
+            }
+            constexpr Angle operator-() const {
+                return fromRadians(-angle);
+            }
+            constexpr Angle operator*(double scale) const {
+                return fromRadians(angle * scale);
+            }
     };
-
-    /**
-     * @brief Converts a given angle in degrees to radians.
-     * @param degrees The angle in degrees to be converted.
-     * @return The angle in radians.
-     */
-    double degreesToRadians(double degrees);
-
-    /**
-     * @brief Converts the current angle from radians to degrees.
-     * @param radians The angle in radians to be converted.
-     * @return The angle in degrees.
-     */
-    double radiansToDegrees(double radians);
-
 }
 
-
-#endif // GEOMETRY_LS_H
\ No newline at end of file
+#endif // GEOMETRY_LS_H
@@ -0,0 +1,174 @@
+/*
+* Contains the controller input layer: every axis and button is read once per tick into a snapshot,
+* and button edges (press, release, hold, double tap) are dispatched to callbacks from a fixed table.
+*/
+#ifndef INPUT_LS_H
+#define INPUT_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Which controller an input comes from.
+     */
+    enum class ControllerId : std::uint8_t {
+        Master,
+        Partner
+    };
+
+    /**
+     * @brief Controller buttons, in the order of pros::controller_digital_e_t.
+     */
+    enum class Button : std::uint8_t {
+        L1, L2, R1, R2,
+        Up, Down, Left, Right,
+        X, B, Y, A
+    };
+    constexpr std::size_t BUTTON_COUNT = 12;
+
+    /**
+     * @brief Controller joystick axes, in the order of pros::controller_analog_e_t.
+     */
+    enum class Axis : std::uint8_t {
+        LeftX, LeftY, RightX, RightY
+    };
+    constexpr std::size_t AXIS_COUNT = 4;
+
+    /**
+     * @brief What a button did this tick.
+     */
+    enum class ButtonEvent : std::uint8_t {
+        Press,
+        Release,
+        Hold, // once, after being held for InputTiming::hold
+        DoubleTap // a press soon enough after the previous one, comes with its Press
+    };
+
+    /**
+     * @brief Everything a controller reported in one tick.
+     */
+    struct ControllerSnapshot {
+        std::array<std::int8_t, AXIS_COUNT> axes{}; // [-127, 127]
+        std::uint16_t buttons = 0; // bit i is set while Button i is down
+        bool connected = false;
+
+        std::int8_t axis(Axis a) const {
+            return axes[static_cast<std::uint8_t>(a)];
+        }
+
+        bool isDown(Button b) const {
+            return buttons & (1u << static_cast<std::uint8_t>(b));
+        }
+    };
+
+    /**
+     * @brief Timings of the button events, in ms.
+     */
+    struct InputTiming {
+        std::uint32_t debounce = 30; // a button's state is ignored for this long after it changes
+        std::uint32_t hold = 500;
+        std::uint32_t doubleTap = 300; // longest time between the presses of a double tap
+    };
+
+    /**
+     * @brief Reads both controllers once per update() and dispatches button events.
+     *
+     * Driver code reads the snapshot (getAxis(), isDown(), wasPressed()...) or binds callbacks with on(),
+     * instead of polling pros::Controller itself, so every input is read exactly once per tick.
+     * A disconnected partner controller costs one read.
+     *
+     * Ex. input.on(ls::ControllerId::Master, ls::Button::R1, ls::ButtonEvent::Press, []() { intake.toggle(); });
+     */
+    class Input {
+        public:
+            static constexpr std::size_t MAX_BINDINGS = 32;
+            using Callback = std::function<void()>;
+
+            /**
+             * @brief Construct a new Input object
+             * @param timing the debounce, hold and double tap times.
+             */
+            explicit Input(InputTiming timing = {});
+
+            /**
+             * @brief Calls 'callback' every time the button does 'event'.
+             * Callbacks run inside update(), in the order they were bound.
+             *
+             * @param controller the controller the button is on.
+             * @param button the button.
+             * @param event what the button has to do.
+             * @param callback the function to call.
+             * @throws std::out_of_range if MAX_BINDINGS callbacks are already bound.
+             */
+            void on(ControllerId controller, Button button, ButtonEvent event, Callback callback);
+
+            /**
+             * @brief Reads both controllers, updates the events and runs the bound callbacks. Call once per tick.
+             */
+            void update();
+
+            /**
+             * @brief Updates one controller from a snapshot instead of the device (ex. replaying a recorded match).
+             *
+             * @param controller the controller the snapshot is from.
+             * @param raw what the controller reported.
+             * @param now the time of the snapshot in ms.
+             */
+            void update(ControllerId controller, const ControllerSnapshot& raw, std::uint32_t now);
+
+            /**
+             * @brief Gets the debounced state of a controller as of the last update().
+             */
+            const ControllerSnapshot& get(ControllerId controller) const;
+
+            /**
+             * @brief Gets an axis as of the last update(), 0 if the controller is disconnected.
+             */
+            std::int8_t getAxis(ControllerId controller, Axis axis) const;
+
+            /**
+             * @brief Returns if the button is down as of the last update().
+             */
+            bool isDown(ControllerId controller, Button button) const;
+
+            /**
+             * @brief Returns if the button did the event in the last update().
+             */
+            bool was(ControllerId controller, Button button, ButtonEvent event) const;
+        private:
+            struct Binding {
+                Callback callback;
+                ControllerId controller;
+                Button button;
+                ButtonEvent event;
+            };
+
+            struct ButtonTimes {
+                std::uint32_t changed = 0; // last accepted change
+                std::uint32_t pressed = 0; // last press
+                bool held = false; // Hold already fired for this press
+                bool tapped = false; // the last press can start a double tap
+            };
+
+            struct ControllerState {
+                ControllerSnapshot snapshot;
+                std::array<ButtonTimes, BUTTON_COUNT> times{};
+                std::array<std::uint16_t, 4> events{}; // bit masks of buttons, indexed by ButtonEvent
+            };
+
+            void dispatch(ControllerId controller);
+
+            InputTiming timing;
+            pros::Controller master{pros::E_CONTROLLER_MASTER};
+            pros::Controller partner{pros::E_CONTROLLER_PARTNER};
+            std::array<ControllerState, 2> states{};
+            std::array<Binding, MAX_BINDINGS> bindings{};
+            std::size_t bindingCount = 0;
+    };
+}
+
+#endif // INPUT_LS_H
@@ -0,0 +1,56 @@
+/*
+* Contains the templated odometry math, shared by every odom class.
+* Templated on the number type so it can run in double, float or fixed-point (see numeric.h).
+*/
+#ifndef KINEMATICS_LS_H
+#define KINEMATICS_LS_H
+
+#include "numeric.h"
+#include "pose.h"
+
+#ifndef LS_ODOM_SCALAR
+#define LS_ODOM_SCALAR double
+#endif
+
+namespace ls {
+    /**
+     * @brief The number type odom does its math in, set with -DLS_ODOM_SCALAR=... (double by default).
+     */
+    using OdomScalar = LS_ODOM_SCALAR;
+
+    /**
+     * @brief Computes the motion of the robot (as a twist in its own frame) from the distances its tracking wheels traveled.
+     * Wheels that sit off center also roll while the robot turns, that part is removed using their offsets.
+     * The result is (forwards, sideways to the right, change in bearing) and is meant for Pose2::exp().
+     * 
+     * @param deltaTheta change in heading in radians (bearing, so clockwise is positive).
+     * @param deltaStrafe distance traveled by the sideways wheel in inches.
+     * @param deltaForward distance traveled by the forwards wheel in inches.
+     * @param strafeOffset distance from the sideways wheel to the center in inches.
+     * @param forwardOffset distance from the forwards wheel to the center in inches.
+     * @return the motion in the robot's frame.
+     */
+    template<typename T>
+    Twist2<T> arcTwist(T deltaTheta, T deltaStrafe, T deltaForward, T strafeOffset, T forwardOffset) {
+        return {deltaForward + forwardOffset * deltaTheta, deltaStrafe + strafeOffset * deltaTheta, deltaTheta};
+    }
+
+    /**
+     * @brief Computes the motion of the robot from two parallel wheels and a sideways wheel.
+     * 
+     * @param deltaL distance traveled by the left wheel in inches.
+     * @param deltaR distance traveled by the right wheel in inches.
+     * @param deltaB distance traveled by the back wheel in inches.
+     * @param centerToLeft distance from the left wheel to the center in inches.
+     * @param centerToRight distance from the right wheel to the center in inches.
+     * @param centerToBack distance from the back wheel to the center in inches.
+     * @return the motion in the robot's frame.
+     */
+    template<typename T>
+    Twist2<T> threeWheelTwist(T deltaL, T deltaR, T deltaB, T centerToLeft, T centerToRight, T centerToBack) {
+        const T deltaTheta = (deltaL - deltaR) / (centerToLeft + centerToRight);
+        return arcTwist(deltaTheta, deltaB, deltaR, centerToBack, centerToRight);
+    }
+}
+
+#endif // KINEMATICS_LS_H
@@ -8,8 +8,31 @@
 #include "odom.h"
 #include "pid.h"
 #include "geometry.h"
+#include "fastmath.h"
+#include "numeric.h"
+#include "pose.h"
+#include "drive.h"
+#include "feedforward.h"
+#include "profile.h"
+#include "kinematics.h"
+#include "velocity.h"
 #include "tracking.h"
+#include "sensorframe.h"
+#include "motorcommand.h"
+#include "motormonitor.h"
+#include "motorstate.h"
+#include "stall.h"
 #include "timer.hpp"
+#include "config.h"
+#include "ports.h"
+#include "input.h"
+#include "controllerdisplay.h"
+#include "fieldview.h"
+#include "colorsort.h"
+#include "alliancelink.h"
+#include "radiotransport.h"
+#include "command.h"
+#include "auton.h"
 
 
 #endif // !LIBSTOGA_LS_H
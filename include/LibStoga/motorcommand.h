@@ -0,0 +1,123 @@
+/*
+* Contains the motor command buffer.
+* Code sets what each motor should do at any point in the tick, and flush() sends only what changed,
+* all at once, so motors that are told the same thing every loop cost no smart port traffic.
+*/
+#ifndef MOTORCOMMAND_LS_H
+#define MOTORCOMMAND_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Caches the last command sent to each registered motor (or motor group) and suppresses repeats.
+     */
+    class MotorCommandBuffer {
+        public:
+            static constexpr std::size_t MAX_MOTORS = 16;
+            using Handle = std::uint8_t;
+
+            /**
+             * @brief Construct a new Motor Command Buffer object
+             *
+             * @param refreshPeriod every this many flushes each motor is sent its command again even if unchanged,
+             * so a motor that was unplugged or reset picks it back up. 0 never refreshes.
+             */
+            explicit MotorCommandBuffer(std::uint32_t refreshPeriod = 50);
+
+            /**
+             * @brief Registers a motor or motor group. Registering the same one again returns the same handle.
+             * The motor must outlive this buffer.
+             *
+             * @param motor the motor to command.
+             * @return the handle to command it with.
+             * @throws std::out_of_range if there are already MAX_MOTORS motors.
+             */
+            Handle add(pros::v5::AbstractMotor& motor);
+
+            /**
+             * @brief Sets the voltage to send on the next flush().
+             *
+             * @param motor the motor's handle.
+             * @param millivolts the voltage [-12000, 12000].
+             */
+            void setVoltage(Handle motor, std::int32_t millivolts);
+
+            /**
+             * @brief Sets the velocity to send on the next flush().
+             *
+             * @param motor the motor's handle.
+             * @param rpm the velocity, range depends on the gearset.
+             */
+            void setVelocity(Handle motor, std::int32_t rpm);
+
+            /**
+             * @brief Brakes the motor (using its brake mode) on the next flush().
+             *
+             * @param motor the motor's handle.
+             */
+            void brake(Handle motor);
+
+            /**
+             * @brief Sets the brake mode to send on the next flush().
+             *
+             * @param motor the motor's handle.
+             * @param mode the brake mode.
+             */
+            void setBrakeMode(Handle motor, pros::v5::MotorBrake mode);
+
+            /**
+             * @brief Sends every command that differs from what was last sent.
+             * Call once per tick, after everything has set its commands.
+             */
+            void flush();
+
+            /**
+             * @brief Makes the next flush() send every command, changed or not.
+             */
+            void invalidate();
+
+            /**
+             * @brief Gets the number of commands sent to motors.
+             */
+            std::uint32_t getWrites() const;
+
+            /**
+             * @brief Gets the number of commands that were not sent since the motor was already doing them.
+             */
+            std::uint32_t getSuppressed() const;
+        private:
+            enum class Mode : std::uint8_t {
+                None,
+                Voltage,
+                Velocity,
+                Brake
+            };
+
+            struct Command {
+                Mode mode = Mode::None;
+                std::int32_t value = 0;
+                pros::v5::MotorBrake brakeMode = pros::v5::MotorBrake::invalid;
+
+                bool sameMotion(const Command& other) const {
+                    return mode == other.mode && value == other.value;
+                }
+            };
+
+            std::array<pros::v5::AbstractMotor*, MAX_MOTORS> motors{};
+            std::array<Command, MAX_MOTORS> wanted{};
+            std::array<Command, MAX_MOTORS> sent{};
+            std::uint8_t count = 0;
+
+            std::uint32_t refreshPeriod;
+            std::uint32_t flushes = 0;
+            bool forceNext = false;
+            std::uint32_t writes = 0;
+            std::uint32_t suppressed = 0;
+    };
+}
+
+#endif // MOTORCOMMAND_LS_H
@@ -0,0 +1,163 @@
+/*
+* Contains the background motor health monitor.
+* Diagnostics (temperature, current, efficiency...) are read in a low priority task, one motor at a time,
+* so the control loop never pays for them.
+*/
+#ifndef MOTORMONITOR_LS_H
+#define MOTORMONITOR_LS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Running statistics for one reading.
+     */
+    struct HealthStat {
+        float last = 0;
+        float min = 0;
+        float max = 0;
+        float average = 0; // exponentially weighted
+    };
+
+    /**
+     * @brief Everything the monitor knows about one motor.
+     */
+    struct MotorHealth {
+        HealthStat temperature; // in degrees Celsius
+        HealthStat current; // in mA
+        HealthStat efficiency; // in percent
+        HealthStat voltage; // in mV
+        bool overTemp = false;
+        bool overCurrent = false;
+        std::uint32_t samples = 0;
+    };
+
+    /**
+     * @brief Something the monitor noticed about a motor.
+     */
+    enum class HealthEvent : std::uint8_t {
+        Hot, // passed the derate temperature, getPowerScale() starts dropping
+        OverTemp, // the motor reports it is over temperature (limiting itself)
+        OverCurrent, // the motor reports it is over current
+        Recovered // back under every threshold
+    };
+
+    /**
+     * @brief Limits the monitor compares against.
+     */
+    struct HealthThresholds {
+        float derateTemperature = 45; // in degrees Celsius, getPowerScale() is 1 below this
+        float cutoffTemperature = 55; // in degrees Celsius, the motor halves its own power here, getPowerScale() reaches minPowerScale
+        float minPowerScale = 0.5f;
+    };
+
+    /**
+     * @brief Samples every registered motor in a low priority task and keeps min/max/average stats.
+     * Motors are sampled one at a time, spread evenly over the period, so no tick takes every read at once.
+     */
+    class MotorMonitor {
+        public:
+            static constexpr std::size_t MAX_MOTORS = 24;
+            using Handle = std::uint8_t;
+            using EventCallback = std::function<void(Handle motor, HealthEvent event)>;
+
+            /**
+             * @brief Construct a new Motor Monitor object
+             *
+             * @param period time in ms for every motor to be sampled once.
+             * @param smoothing weight of each new sample in the averages, (0, 1].
+             * @param thresholds the limits events are raised at.
+             * @throws std::invalid_argument if smoothing is out of range.
+             */
+            explicit MotorMonitor(std::uint32_t period = 200, float smoothing = 0.1f, HealthThresholds thresholds = {});
+            ~MotorMonitor();
+
+            /**
+             * @brief Registers a motor, or every motor of a group (returning the first handle, the rest follow in order).
+             * The motor must outlive this monitor.
+             *
+             * @param motor the motor or group to watch.
+             * @return the handle of the (first) motor.
+             * @throws std::out_of_range if there is no room for every motor.
+             */
+            Handle add(pros::v5::AbstractMotor& motor);
+
+            /**
+             * @brief Sets the function called when a motor crosses a threshold.
+             * Runs inside the monitor task, so it must not block for long.
+             *
+             * @param callback the function to call.
+             */
+            void onEvent(EventCallback callback);
+
+            /**
+             * @brief Starts the monitor task, at the lowest priority above idle.
+             */
+            void start();
+
+            /**
+             * @brief Stops the monitor task.
+             */
+            void stop();
+
+            /**
+             * @brief Gets a copy of a motor's stats.
+             *
+             * @param motor the motor's handle.
+             */
+            MotorHealth getHealth(Handle motor);
+
+            /**
+             * @brief Gets how much power the motor should be given, drops from 1 to minPowerScale as it heats up.
+             * Lock free and reads no device, so it is safe to call from the control loop.
+             *
+             * @param motor the motor's handle.
+             */
+            float getPowerScale(Handle motor) const;
+
+            /**
+             * @brief Gets the lowest power scale of 'count' motors from 'first', ex. the motors of a group,
+             * which share one voltage so the hottest of them sets it.
+             *
+             * @param first the handle of the first motor.
+             * @param count the number of motors.
+             */
+            float getPowerScale(Handle first, std::size_t count) const;
+
+            /**
+             * @brief Gets the number of registered motors.
+             */
+            std::size_t getCount() const;
+        private:
+            struct Entry {
+                pros::v5::AbstractMotor* motor;
+                std::uint8_t index; // index in its group
+            };
+
+            void loop();
+            void sample(Handle motor);
+
+            std::array<Entry, MAX_MOTORS> entries{};
+            std::array<MotorHealth, MAX_MOTORS> health{};
+            std::array<std::atomic<float>, MAX_MOTORS> powerScale;
+            std::array<std::uint8_t, MAX_MOTORS> alerts{}; // HealthEvent bits already raised, so each fires once
+            std::atomic<std::uint8_t> count = 0;
+
+            std::uint32_t period;
+            float smoothing;
+            HealthThresholds thresholds;
+            EventCallback callback;
+
+            pros::Mutex mutex;
+            std::unique_ptr<pros::Task> task = nullptr;
+            std::atomic<bool> running = false;
+    };
+}
+
+#endif // MOTORMONITOR_LS_H
@@ -0,0 +1,99 @@
+/*
+* Contains the per tick motor telemetry cache.
+* Motors are read once per tick into one snapshot that every consumer (stall detection, feedforward, screens...)
+* reads from, instead of each of them asking the motor again.
+*/
+#ifndef MOTORSTATE_LS_H
+#define MOTORSTATE_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Snapshot of every registered motor, one array per value (indexed by MotorStateCache handles).
+     */
+    struct MotorStates {
+        static constexpr std::size_t MAX_MOTORS = 24;
+
+        std::array<double, MAX_MOTORS> position{}; // in degrees
+        std::array<double, MAX_MOTORS> velocity{}; // in rpm
+        std::array<std::int32_t, MAX_MOTORS> current{}; // in mA
+        std::array<std::int32_t, MAX_MOTORS> voltage{}; // in mV
+        std::array<std::uint64_t, MAX_MOTORS> readTime{}; // pros::micros() when the motor was read
+        std::array<bool, MAX_MOTORS> valid{}; // false if the last read failed (ex. unplugged)
+        std::uint32_t sequence = 0; // counts up every refresh, 0 before the first one
+    };
+
+    /**
+     * @brief Reads registered motors into a MotorStates snapshot.
+     * Call refresh() once per tick (ex. in a Scheduler tick hook), then read from the snapshot anywhere.
+     */
+    class MotorStateCache {
+        public:
+            using Handle = std::uint8_t;
+
+            /**
+             * @brief Registers a motor, or every motor of a group (returning the first handle, the rest follow in order).
+             * Registering the same motor again returns the same handle. The motor must outlive this cache.
+             *
+             * @param motor the motor or group to read.
+             * @return the handle of the (first) motor.
+             * @throws std::out_of_range if there is no room for every motor.
+             */
+            Handle add(pros::v5::AbstractMotor& motor);
+
+            /**
+             * @brief Reads every registered motor.
+             */
+            void refresh();
+
+            /**
+             * @brief Reads every registered motor, unless the snapshot is newer than maxAge.
+             * Lets several consumers call it each tick while only the first one pays for the reads.
+             *
+             * @param maxAge the oldest snapshot (in microseconds) that is still used as is.
+             * @return if the motors were read.
+             */
+            bool refresh(std::uint64_t maxAge);
+
+            /**
+             * @brief Gets the snapshot.
+             */
+            const MotorStates& getStates() const;
+
+            double getPosition(Handle motor) const;
+            double getVelocity(Handle motor) const;
+            std::int32_t getCurrent(Handle motor) const;
+            std::int32_t getVoltage(Handle motor) const;
+            bool isValid(Handle motor) const;
+
+            /**
+             * @brief Gets how old a motor's values are.
+             *
+             * @param motor the motor's handle.
+             * @return the age in microseconds.
+             */
+            std::uint64_t getAge(Handle motor) const;
+
+            /**
+             * @brief Gets the total number of device reads made, to compare against the consumers served.
+             */
+            std::uint32_t getReads() const;
+        private:
+            struct Entry {
+                pros::v5::AbstractMotor* motor;
+                std::uint8_t index; // index in its group
+            };
+
+            std::array<Entry, MotorStates::MAX_MOTORS> entries{};
+            std::uint8_t count = 0;
+            MotorStates states;
+            std::uint64_t lastRefresh = 0;
+            std::uint32_t reads = 0;
+    };
+}
+
+#endif // MOTORSTATE_LS_H
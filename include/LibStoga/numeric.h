@@ -0,0 +1,336 @@
+/*
+* Contains the numeric policy used by the templated math kernels (PID, odom, geometry helpers),
+* and the fixed-point types that can be used in place of float/double.
+*
+* Fixed-point math is pure integer math, so the results are bit-for-bit the same on the
+* robot and on a desktop simulator, which float/double through libm does not guarantee.
+*/
+#ifndef NUMERIC_LS_H
+#define NUMERIC_LS_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "geometry.h"
+#include "fastmath.h"
+
+namespace ls {
+    namespace detail {
+        /**
+         * @brief Returns the upper bits of a 64x64 bit product shifted right by 'shift'.
+         * Needed for Q32.32 since the robot has no 128 bit integer type. Rounds towards zero.
+         */
+        constexpr std::int64_t mulShift64(std::int64_t a, std::int64_t b, int shift) {
+            const bool negative = (a < 0) != (b < 0);
+            const std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            const std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+
+            const std::uint64_t aLo = ua & 0xFFFFFFFF, aHi = ua >> 32;
+            const std::uint64_t bLo = ub & 0xFFFFFFFF, bHi = ub >> 32;
+            const std::uint64_t loLo = aLo * bLo;
+            const std::uint64_t hiLo = aHi * bLo;
+            const std::uint64_t loHi = aLo * bHi;
+            const std::uint64_t hiHi = aHi * bHi;
+
+            const std::uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + (loHi & 0xFFFFFFFF);
+            const std::uint64_t upper = hiHi + (hiLo >> 32) + (loHi >> 32) + (cross >> 32);
+            const std::uint64_t lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+
+            const std::uint64_t result = shift == 0 ? lower : (upper << (64 - shift)) | (lower >> shift);
+            return negative ? -static_cast<std::int64_t>(result) : static_cast<std::int64_t>(result);
+        }
+
+        /**
+         * @brief Returns (a << shift) / b using 128 bit long division. Rounds towards zero.
+         * Division by zero saturates instead of trapping.
+         */
+        constexpr std::int64_t divShift64(std::int64_t a, std::int64_t b, int shift) {
+            if (b == 0) return a >= 0 ? std::numeric_limits<std::int64_t>::max() : std::numeric_limits<std::int64_t>::min();
+            const bool negative = (a < 0) != (b < 0);
+            const std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            const std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+
+            const std::uint64_t hi = shift == 0 ? 0 : ua >> (64 - shift);
+            const std::uint64_t lo = ua << shift;
+            std::uint64_t quotient = 0;
+            std::uint64_t remainder = 0;
+            for (int i = 127; i >= 0; i--) {
+                const std::uint64_t bit = i >= 64 ? (hi >> (i - 64)) & 1 : (lo >> i) & 1;
+                remainder = (remainder << 1) | bit;
+                if (remainder >= ub) {
+                    remainder -= ub;
+                    if (i < 64) quotient |= std::uint64_t(1) << i;
+                }
+            }
+            return negative ? -static_cast<std::int64_t>(quotient) : static_cast<std::int64_t>(quotient);
+        }
+
+        /**
+         * @brief Bit by bit integer square root (floor(sqrt(x))).
+         */
+        constexpr std::uint64_t isqrt(std::uint64_t x) {
+            std::uint64_t result = 0;
+            std::uint64_t bit = std::uint64_t(1) << 62;
+            while (bit > x) bit >>= 2;
+            while (bit != 0) {
+                if (x >= result + bit) {
+                    x -= result + bit;
+                    result = (result >> 1) + bit;
+                } else {
+                    result >>= 1;
+                }
+                bit >>= 2;
+            }
+            return result;
+        }
+
+        /**
+         * @brief sin() that can run at compile time, only used to build the lookup tables.
+         */
+        constexpr double constexprSin(double x) {
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 20; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        /**
+         * @brief atan() for x in [0, 1] that can run at compile time, only used to build the lookup tables.
+         * Uses atan(x) = 2 * atan(x / (1 + sqrt(1 + x^2))) once so the series converges quickly.
+         */
+        constexpr double constexprAtan(double x) {
+            double root = 1;
+            const double square = 1 + x * x;
+            for (int i = 0; i < 30; i++) root = 0.5 * (root + square / root);
+            const double y = x / (1 + root);
+            double term = y;
+            double sum = y;
+            for (int n = 1; n < 40; n++) {
+                term *= -y * y;
+                sum += term / (2 * n + 1);
+            }
+            return 2 * sum;
+        }
+    }
+
+    /**
+     * @brief A signed fixed-point number with FRAC fractional bits stored in 'Storage'.
+     *
+     * Use the Q16_16 and Q32_32 aliases. Arithmetic wraps on overflow like the underlying integer,
+     * except division by zero which saturates.
+     */
+    template<int FRAC, typename Storage>
+    class Fixed {
+        static_assert(std::is_same_v<Storage, std::int32_t> || std::is_same_v<Storage, std::int64_t>, "Fixed only supports int32_t or int64_t storage.");
+        static_assert(FRAC > 0 && FRAC < static_cast<int>(sizeof(Storage) * 8) - 1, "Fixed needs at least one integer bit.");
+    public:
+        using storage_type = Storage;
+        static constexpr int FRACTIONAL_BITS = FRAC;
+        static constexpr Storage ONE = Storage(1) << FRAC;
+
+        constexpr Fixed(): raw(0) {}
+        /**
+         * @brief Converts from a double, rounding to the nearest representable value.
+         * @param value the value to convert.
+         */
+        constexpr explicit Fixed(double value): raw(static_cast<Storage>(value * ONE + (value >= 0 ? 0.5 : -0.5))) {}
+        /**
+         * @brief Makes a number straight from its underlying integer.
+         * @param raw the raw integer, 'ONE' represents 1.0
+         */
+        static constexpr Fixed fromRaw(Storage raw) {
+            Fixed f;
+            f.raw = raw;
+            return f;
+        }
+
+        constexpr Storage getRaw() const { return raw; }
+        constexpr double toDouble() const { return static_cast<double>(raw) / ONE; }
+        constexpr explicit operator double() const { return toDouble(); }
+        constexpr explicit operator float() const { return static_cast<float>(toDouble()); }
+
+        constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+        constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+        constexpr Fixed operator-() const { return fromRaw(-raw); }
+        constexpr Fixed operator*(Fixed other) const {
+            if constexpr (sizeof(Storage) == 4) {
+                return fromRaw(static_cast<Storage>((static_cast<std::int64_t>(raw) * other.raw) >> FRAC));
+            } else {
+                return fromRaw(detail::mulShift64(raw, other.raw, FRAC));
+            }
+        }
+        constexpr Fixed operator/(Fixed other) const {
+            if constexpr (sizeof(Storage) == 4) {
+                if (other.raw == 0) return fromRaw(raw >= 0 ? std::numeric_limits<Storage>::max() : std::numeric_limits<Storage>::min());
+                return fromRaw(static_cast<Storage>((static_cast<std::int64_t>(raw) << FRAC) / other.raw));
+            } else {
+                return fromRaw(detail::divShift64(raw, other.raw, FRAC));
+            }
+        }
+        constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+        constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+        constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+        constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+        constexpr bool operator==(const Fixed& other) const = default;
+        constexpr auto operator<=>(const Fixed& other) const = default;
+    private:
+        Storage raw;
+    };
+
+    using Q16_16 = Fixed<16, std::int32_t>;
+    using Q32_32 = Fixed<32, std::int64_t>;
+
+    template<typename T>
+    struct is_fixed : std::false_type {};
+    template<int FRAC, typename Storage>
+    struct is_fixed<Fixed<FRAC, Storage>> : std::true_type {};
+
+    /**
+     * @brief The numeric policy: how the templated kernels make constants and do transcendental math with T.
+     *
+     * float and double go through libm, or through ls::fastmath when built with -DLS_USE_FASTMATH.
+     * Fixed types go through the lookup tables below.
+     */
+    template<typename T>
+    struct Numeric {
+        static_assert(std::is_floating_point_v<T>, "Numeric is only defined for float, double and Fixed.");
+        static constexpr T from(double value) { return static_cast<T>(value); }
+        static constexpr double toDouble(T value) { return static_cast<double>(value); }
+        static constexpr T abs(T x) { return x < 0 ? -x : x; }
+#ifdef LS_USE_FASTMATH
+        static T sin(T x) { return fastmath::sin(x); }
+        static T cos(T x) { return fastmath::cos(x); }
+        static void sincos(T x, T& s, T& c) { fastmath::sincos(x, s, c); }
+        static T atan2(T y, T x) { return fastmath::atan2(y, x); }
+        static T hypot(T x, T y) { return fastmath::hypot(x, y); }
+#else
+        static T sin(T x) { return std::sin(x); }
+        static T cos(T x) { return std::cos(x); }
+        static void sincos(T x, T& s, T& c) { s = std::sin(x); c = std::cos(x); }
+        static T atan2(T y, T x) { return std::atan2(y, x); }
+        // not std::hypot: its overflow handling makes it slower, and no distance on a field comes near overflowing.
+        static T hypot(T x, T y) { return std::sqrt(x * x + y * y); }
+#endif
+        static T sqrt(T x) { return std::sqrt(x); }
+    };
+
+    /**
+     * @brief Lookup table math for fixed-point numbers.
+     *
+     * sin/cos use a 257 entry quarter wave table and atan2 a 257 entry atan table on [0, 1],
+     * both linearly interpolated. sqrt is a bit by bit integer square root, within 1 LSB of the exact root.
+     * Max error against the double the caller converted from, from test/numeric_bench.cpp: sin/cos over [-4pi, 4pi],
+     * atan2 in every direction at 1, 144 and 10000 in, sqrt over [0.01, 10000]:
+     *   Q16.16: sin/cos 3.5e-5, atan2 5.3e-5 rad, sqrt 5.2e-5
+     *   Q32.32: sin/cos 4.8e-6, atan2 1.3e-6 rad, sqrt 8e-9 relative
+     * Table interpolation dominates the error for Q32.32, the LSB dominates for Q16.16.
+     * On the host a Q16.16 sin or atan2 is ~3x faster than libm's double, a Q32.32 sin is on par.
+     * Q32.32 atan2 (128 step long division) and both sqrts are 50x slower than libm: keep them out of tight loops.
+     */
+    template<int FRAC, typename Storage>
+    struct Numeric<Fixed<FRAC, Storage>> {
+        using T = Fixed<FRAC, Storage>;
+        static constexpr std::size_t TABLE_BITS = 8;
+        static constexpr std::size_t TABLE_SIZE = std::size_t(1) << TABLE_BITS;
+
+        static constexpr std::array<Storage, TABLE_SIZE + 1> makeSinTable() {
+            std::array<Storage, TABLE_SIZE + 1> table{};
+            for (std::size_t i = 0; i <= TABLE_SIZE; i++) {
+                table[i] = T(detail::constexprSin(PI / 2 * i / TABLE_SIZE)).getRaw();
+            }
+            return table;
+        }
+        static constexpr std::array<Storage, TABLE_SIZE + 1> makeAtanTable() {
+            std::array<Storage, TABLE_SIZE + 1> table{};
+            for (std::size_t i = 0; i <= TABLE_SIZE; i++) {
+                table[i] = T(detail::constexprAtan(static_cast<double>(i) / TABLE_SIZE)).getRaw();
+            }
+            return table;
+        }
+        static constexpr std::array<Storage, TABLE_SIZE + 1> SIN_TABLE = makeSinTable();
+        static constexpr std::array<Storage, TABLE_SIZE + 1> ATAN_TABLE = makeAtanTable();
+
+        static constexpr T from(double value) { return T(value); }
+        static constexpr double toDouble(T value) { return value.toDouble(); }
+        static constexpr T abs(T x) { return x < T() ? -x : x; }
+
+        /**
+         * @brief Linearly interpolates between table[index] and table[index + step] by a FRAC bit fraction.
+         */
+        static constexpr Storage lerp(Storage a, Storage b, Storage fraction) {
+            return a + (T::fromRaw(b - a) * T::fromRaw(fraction)).getRaw();
+        }
+
+        static constexpr T sin(T x) {
+            // turn the angle into quarter-wave table steps: 4 * TABLE_SIZE steps per turn.
+            constexpr T STEPS_PER_RADIAN = T(4 * TABLE_SIZE / TAU);
+            const Storage phase = (x * STEPS_PER_RADIAN).getRaw();
+            const Storage step = phase >> FRAC; // floor, so negative angles wrap correctly.
+            const Storage fraction = phase & (T::ONE - 1);
+            const std::size_t quadrant = static_cast<std::size_t>(step >> TABLE_BITS) & 3;
+            const std::size_t i = static_cast<std::size_t>(step) & (TABLE_SIZE - 1);
+
+            Storage value;
+            if (quadrant & 1) {
+                value = lerp(SIN_TABLE[TABLE_SIZE - i], SIN_TABLE[TABLE_SIZE - i - 1], fraction);
+            } else {
+                value = lerp(SIN_TABLE[i], SIN_TABLE[i + 1], fraction);
+            }
+            return T::fromRaw(quadrant & 2 ? -value : value);
+        }
+
+        static constexpr T cos(T x) {
+            return sin(x + T(PI / 2));
+        }
+
+        static constexpr void sincos(T x, T& s, T& c) {
+            s = sin(x);
+            c = cos(x);
+        }
+
+        /**
+         * @brief atan of a ratio in [0, 1] from the table.
+         */
+        static constexpr T atanUnit(T ratio) {
+            const Storage position = (ratio * T(static_cast<double>(TABLE_SIZE))).getRaw();
+            const std::size_t i = static_cast<std::size_t>(position >> FRAC);
+            if (i >= TABLE_SIZE) return T::fromRaw(ATAN_TABLE[TABLE_SIZE]);
+            return T::fromRaw(lerp(ATAN_TABLE[i], ATAN_TABLE[i + 1], position & (T::ONE - 1)));
+        }
+
+        static constexpr T atan2(T y, T x) {
+            const T ax = abs(x);
+            const T ay = abs(y);
+            if (ax == T() && ay == T()) return T();
+            T angle = ax >= ay ? atanUnit(ay / ax) : T(PI / 2) - atanUnit(ax / ay);
+            if (x < T()) angle = T(PI) - angle;
+            return y < T() ? -angle : angle;
+        }
+
+        static constexpr T sqrt(T x) {
+            static_assert(FRAC % 2 == 0, "sqrt needs an even number of fractional bits.");
+            if (x <= T()) return T();
+            // normalize so the integer root keeps as many bits as possible, then undo the shift.
+            const std::uint64_t raw = static_cast<std::uint64_t>(x.getRaw());
+            int shift = 0;
+            while (shift < 62 && (raw << shift) < (std::uint64_t(1) << 62)) shift += 2;
+            const std::uint64_t root = detail::isqrt(raw << shift);
+            const int exponent = FRAC - shift; // always even since FRAC and shift are.
+            const std::uint64_t result = exponent >= 0 ? root << (exponent / 2) : root >> (-exponent / 2);
+            return T::fromRaw(static_cast<Storage>(result));
+        }
+
+        static constexpr T hypot(T x, T y) {
+            return sqrt(x * x + y * y);
+        }
+    };
+}
+
+#endif // NUMERIC_LS_H
@@ -10,6 +10,8 @@
 #include <vector>
 #include "tracking.h"
 #include "geometry.h"
+#include "kinematics.h"
+#include "sensorframe.h"
 #include "api.h"
 #include <cmath>
 
@@ -66,7 +68,7 @@ namespace ls {
 		/**
 		 * @brief Gets the of the resulting line of this position to the other given position.
 		 * Will return in terms of a bearing.
-		 * Will return inf if the positions are way to close or equal to be calculated properly.
+		 * If the positions are equal the result has no meaning (isBehind() returns 0 for those).
 		 * 
 		 * @param pos the other position.
 		 * @return Angle in [0, 360)
@@ -75,7 +77,7 @@ namespace ls {
 		/**
 		 * @brief Gets the of the resulting line of this position to the other given position.
 		 * Will return in terms of a bearing, but will not be bounded from [0, 360)
-		 * Will return inf if the positions are way to close or equal to be calculated properly.
+		 * If the positions are equal the result has no meaning (isBehind() returns 0 for those).
 		 * 
 		 * @param pos the other position.
 		 * @return Angle not bounded to [0, 360)
@@ -99,7 +101,7 @@ namespace ls {
 		* 
 		* @param ports the ports that this Odom object uses
 		*/
-		virtual void initialize(std::initializer_list<uint8_t> ports) = 0;
+		virtual void initialize(std::initializer_list<int8_t> ports) = 0;
 		/**
 		* @brief Computes the new coordinations and angle of the robot since the program has started.
 		* Assumes that (0, 0) is where the robot starts at reboot.
@@ -107,10 +109,29 @@ namespace ls {
 		* 
 		* Must give X, Y, and angle new values after this call is over.
 		* 
+		* Samples the sampler given to attach() (or one of its own, made on first call) and then calls compute(frame).
+		* If the sampler is shared with other consumers, call sample() once per tick and use compute(frame) instead.
+		* 
 		* @throws std::bad_function_call if object has not been initialized properly.
 		*/
 		virtual void compute();
 		/**
+		* @brief Computes the new coordinates and angle from an already sampled frame.
+		* The frame must come from the sampler given to attach().
+		* The first frame after attach() only records the sensor values, there is nothing to compare it to.
+		* 
+		* @param frame the sensor values for this tick.
+		*/
+		virtual void compute(const SensorFrame& frame) = 0;
+		/**
+		* @brief Registers this object's sensors with the sampler, so its frames can be passed to compute(frame).
+		* Call after initialize(), since initialize() replaces the sensors.
+		* 
+		* @param sensors the sampler to read from.
+		* @throws std::bad_function_call if object has not been initialized properly.
+		*/
+		virtual void attach(SensorSampler& sensors) = 0;
+		/**
 		* Gets the x-coordinate value of the robot since program started.
 		* Assumes (0, 0) is when the robot started.
 		* 
@@ -159,37 +180,62 @@ namespace ls {
 		*/
 		virtual void resetAll();
 		/**
-		* Gets the change in X since the previous call of this method.
+		* Gets the change in X (field frame) over the last compute().
 		* Does not call resetX() or reset the coordinates in any way.
 		* 
-		* Will return 0 on first call.
+		* Will return 0 before the first compute().
 		* 
 		* @returns the delta in the x-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
 		*/
-		virtual double getDeltaX() = 0;
+		virtual double getDeltaX();
 		/**
-		* Gets the change in Y since the previous call of this method.
+		* Gets the change in Y (field frame) over the last compute().
 		* Does not call resetY() or reset the coordinates in any way.
 		*
-		* Will return 0 on first call.
+		* Will return 0 before the first compute().
 		*
 		* @returns the delta in the y-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
 		*/
-		virtual double getDeltaY() = 0;
+		virtual double getDeltaY();
 		/**
-		* Gets the change in angle since the previous call of this method.
+		* Gets the change in angle over the last compute().
 		* Does not call resetAngle() or reset the angle in any way.
 		*
-		* Will return 0 on first call.
+		* Will return 0 before the first compute().
 		*
 		* @returns the delta in the angle
-		* @throws std::bad_function_call if object is not initialized properly.
 		*/
-		virtual Angle getDeltaAngle() = 0;
+		virtual Angle getDeltaAngle();
+		/**
+		* Gets the movement over the last compute() in the robot's own frame:
+		* forwards (inches), to the right (inches) and the change in bearing (radians).
+		* 
+		* Will return 0 before the first compute().
+		* 
+		* @returns the delta in the robot's frame
+		*/
+		virtual Twist2<double> getLocalDelta();
 	protected:
+		/**
+		* @brief Moves the pose along the given twist (through the SE(2) exponential map).
+		* Called by subclasses at the end of compute() once they have read their sensors.
+		* 
+		* @param twist motion over this update in the robot's frame: forwards, right, change in bearing (radians).
+		*/
+		void integrate(const Twist2<OdomScalar>& twist);
+
+		// Pose2 is kept as (Y, X, bearing): a bearing turns clockwise from +Y towards +X,
+		// which is the usual counter-clockwise SE(2) rotation once the two axes are swapped.
+		Pose2<OdomScalar> pose;
+		double deltaX = 0;
+		double deltaY = 0;
+		Angle deltaAngle;
+		Twist2<double> localDelta{};
 		Position prev_pos;
+
+		SensorSampler* sampler = nullptr;
+		std::unique_ptr<SensorSampler> ownSampler = nullptr; // used by compute() when never attached
+		bool primed = false; // whether a frame has been seen since attach()
 	};
 
 	/**
@@ -206,10 +252,18 @@ namespace ls {
 		double centerToRight; // in inches
 		double centerToLeft; // in inches
 		double centerToBack; // in inches
+		double wheelRadius = 0; // in inches, of the wheels initialize() builds, 0 if the wheels were given
 
 		double deltaL = 0; // in inches
 		double deltaR = 0; // in inches
 		double deltaB = 0; // in inches
+
+		SensorSampler::Handle rightSensor = 0;
+		SensorSampler::Handle leftSensor = 0;
+		SensorSampler::Handle backSensor = 0;
+		double prevL = 0; // in inches
+		double prevR = 0; // in inches
+		double prevB = 0; // in inches
 		
 	public:
 		/**
@@ -218,8 +272,9 @@ namespace ls {
 		 * @param center_to_right distance from right tracking wheel to center in inches.
 		 * @param center_to_left distance from left tracking wheel to center in inches.
 		 * @param center_to_back distance from back tracking wheel to center in inches.
+		 * @param wheel_radius radius of the tracking wheels initialize() builds in inches.
 		 */
-		ThreeWheelOdom(double center_to_right, double center_to_left, double center_to_back);
+		ThreeWheelOdom(double center_to_right, double center_to_left, double center_to_back, double wheel_radius);
 
 		/**
 		 * @brief Construct a new Three Wheel Odom object
@@ -236,47 +291,19 @@ namespace ls {
 		/**
 		 * @brief Initializes the following object with the given ports.
 		 * Constructions default pros::Rotation objects on these ports.
-		 * 1st represents right, 2nd represents left, 3rd represents back.
-		 * If the list does not contain 3 valid ports, an std::invalid_argument exception will be thrown.
+		 * 1st represents right, 2nd represents left, 3rd represents back, negative if reversed.
+		 * The wheels have the radius given to the constructor.
+		 * If the list does not contain 3 valid ports ([-21, -1] U [1, 21]), or this object was built from wheel objects
+		 * and has no radius, an std::invalid_argument exception will be thrown.
 		 * 
-		 * @param ports list of ports in the following order: right, left, sensor.
+		 * @param ports list of ports in the following order: right, left, back.
 		 */
-		void initialize(std::initializer_list<uint8_t> ports) override;
-
-		/**
-		* Gets the change in X since the previous call of this method.
-		* Does not call resetX() or reset the coordinates in any way.
-		* 
-		* Will return 0 on first call.
-		* 
-		* @returns the delta in the x-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		double getDeltaX() override;
-
-		/**
-		* Gets the change in Y since the previous call of this method.
-		* Does not call resetY() or reset the coordinates in any way.
-		*
-		* Will return 0 on first call.
-		*
-		* @returns the delta in the y-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		double getDeltaY() override;
+		void initialize(std::initializer_list<int8_t> ports) override;
 
-		/**
-		* Gets the change in angle since the previous call of this method.
-		* Does not call resetAngle() or reset the angle in any way.
-		*
-		* Will return 0 on first call.
-		*
-		* @returns the delta in the angle
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		Angle getDeltaAngle() override;
+		void attach(SensorSampler& sensors) override;
 
-		void compute() override;
+		using AbstractOdom::compute;
+		void compute(const SensorFrame& frame) override;
 	};
 
 	/**
@@ -291,10 +318,17 @@ namespace ls {
 
 		double centerToVert; // in inches
 		double centerToHoriz; // in inches
-		double prevRotation; // in inches
+		double wheelRadius = 0; // in inches, of the wheels initialize() builds, 0 if the wheels were given
+		double prevRotation = 0; // in degrees
 
 		double deltaH = 0; // in inches
 		double deltaV = 0; // in inches
+
+		SensorSampler::Handle horizSensor = 0;
+		SensorSampler::Handle vertSensor = 0;
+		SensorSampler::Handle imuSensor = 0;
+		double prevH = 0; // in inches
+		double prevV = 0; // in inches
 		
 	public:
 		/**
@@ -302,8 +336,9 @@ namespace ls {
 		 * 
 		 * @param center_to_horiz distance from horizontal tracking wheel to center in inches.
 		 * @param center_to_vert distance from vertical tracking wheel to center in inches.
+		 * @param wheel_radius radius of the tracking wheels initialize() builds in inches.
 		 */
-		ImuOdom(double center_to_horiz, double center_to_vert);
+		ImuOdom(double center_to_horiz, double center_to_vert, double wheel_radius);
 
 		/**
 		 * @brief Construct a new Imu Odom object
@@ -319,47 +354,19 @@ namespace ls {
 		/**
 		 * @brief Initializes the following object with the given ports.
 		 * Constructions default pros::Rotation objects for wheels.
-		 * 1st represents horiz, 2nd represents vert, 3rd represents IMU.
-		 * If the list does not contain 3 valid ports, an std::invalid_argument exception will be thrown.
+		 * 1st represents horiz, 2nd represents vert, 3rd represents IMU, negative if reversed (ignored for the IMU).
+		 * The wheels have the radius given to the constructor.
+		 * If the list does not contain 3 valid ports ([-21, -1] U [1, 21]), or this object was built from wheel objects
+		 * and has no radius, an std::invalid_argument exception will be thrown.
 		 * 
-		 * @param ports list of ports in the following order: right, left, sensor.
+		 * @param ports list of ports in the following order: horiz, vert, IMU.
 		 */
-		void initialize(std::initializer_list<uint8_t> ports) override;
-
-		/**
-		* Gets the change in X since the previous call of this method.
-		* Does not call resetX() or reset the coordinates in any way.
-		* 
-		* Will return 0 on first call.
-		* 
-		* @returns the delta in the x-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		double getDeltaX() override;
+		void initialize(std::initializer_list<int8_t> ports) override;
 
-		/**
-		* Gets the change in Y since the previous call of this method.
-		* Does not call resetY() or reset the coordinates in any way.
-		*
-		* Will return 0 on first call.
-		*
-		* @returns the delta in the y-coordinate value
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		double getDeltaY() override;
-
-		/**
-		* Gets the change in angle since the previous call of this method.
-		* Does not call resetAngle() or reset the angle in any way.
-		*
-		* Will return 0 on first call.
-		*
-		* @returns the delta in the angle
-		* @throws std::bad_function_call if object is not initialized properly.
-		*/
-		Angle getDeltaAngle() override;
+		void attach(SensorSampler& sensors) override;
 
-		void compute() override;
+		using AbstractOdom::compute;
+		void compute(const SensorFrame& frame) override;
 	};
 };
 
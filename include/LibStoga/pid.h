@@ -4,11 +4,16 @@
 #ifndef PID_H
 #define PID_H
 
+#include "numeric.h"
+
 namespace ls {
     /**
      * @brief The PID object, calculates PID outputs given an error.
+     * 
+     * Templated on the number type (see numeric.h), instantiated for float, double, Q16_16 and Q32_32.
      */
-    class PID {
+    template<typename T>
+    class BasicPID {
         public:
             /**
              * @brief Construct a new PID object
@@ -19,28 +24,29 @@ namespace ls {
              * @param windupRange desired windup range
              * @param signFlipReset if signed is fliped already.
              */
-            PID(float kP, float kI, float kD, float windupRange, bool signFlipReset);
+            BasicPID(T kP, T kI, T kD, T windupRange, bool signFlipReset);
             /**
              * @brief calculate the new PID value given the error.
              * 
              * @param error the error from target
              * @return the value from PID
              */
-            float update(const float error);
+            T update(const T error);
             /**
              * @brief Resets the integral and other variables to reset PID state to original. 
              */
             void reset();
-
         protected:
-            float kP;
-            float kI;
-            float kD;
-            float windupRange;
+            T kP;
+            T kI;
+            T kD;
+            T windupRange;
             bool signFlipReset;
-            float integral;
-            float prevError;
+            T integral;
+            T prevError;
         };
+
+    using PID = BasicPID<float>;
 } 
 
 #endif 
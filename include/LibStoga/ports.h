@@ -0,0 +1,76 @@
+/*
+* Contains constexpr checks for smart and ADI port assignments.
+* Meant for static_assert on robot configs, so a wrong port fails the build instead of the match.
+*/
+#ifndef PORTS_LS_H
+#define PORTS_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ls {
+    /**
+     * @brief Number of smart ports on the brain.
+     */
+    constexpr int SMART_PORT_COUNT = 21;
+
+    /**
+     * @brief Checks a smart port, negative (reversed) ports are allowed.
+     *
+     * @param port the port.
+     * @return if the port is in [-21, -1] U [1, 21].
+     */
+    constexpr bool isSmartPort(int port) {
+        const int absPort = port < 0 ? -port : port;
+        return absPort >= 1 && absPort <= SMART_PORT_COUNT;
+    }
+
+    /**
+     * @brief Checks a three wire (ADI) port on the brain.
+     *
+     * @param port the port letter.
+     * @return if the port is in 'A'-'H' (either case).
+     */
+    constexpr bool isAdiPort(char port) {
+        return (port >= 'A' && port <= 'H') || (port >= 'a' && port <= 'h');
+    }
+
+    /**
+     * @brief Checks that no smart port is used twice, whatever its direction. Entries that are 0 (unused) are skipped.
+     *
+     * @param ports every smart port used by the robot.
+     * @return if every port is used once.
+     */
+    template<std::size_t N>
+    constexpr bool uniqueSmartPorts(const std::array<std::int8_t, N>& ports) {
+        for (std::size_t i = 0; i < N; i++) {
+            const int a = ports[i] < 0 ? -ports[i] : ports[i];
+            if (a == 0) continue;
+            for (std::size_t j = 0; j < i; j++) {
+                if (a == (ports[j] < 0 ? -ports[j] : ports[j])) return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks that no ADI port is used twice, ignoring case. Entries that are '\0' (unused) are skipped.
+     *
+     * @param ports every ADI port used by the robot.
+     * @return if every port is used once.
+     */
+    template<std::size_t N>
+    constexpr bool uniqueAdiPorts(const std::array<char, N>& ports) {
+        for (std::size_t i = 0; i < N; i++) {
+            if (ports[i] == '\0') continue;
+            const char a = ports[i] >= 'a' ? ports[i] - ('a' - 'A') : ports[i];
+            for (std::size_t j = 0; j < i; j++) {
+                if (a == (ports[j] >= 'a' ? ports[j] - ('a' - 'A') : ports[j])) return false;
+            }
+        }
+        return true;
+    }
+}
+
+#endif // PORTS_LS_H
@@ -0,0 +1,151 @@
+/*
+* Contains the SE(2) Lie group types used to integrate odometry.
+* Templated on the number type, like the rest of the kernels (see numeric.h).
+*/
+#ifndef POSE_LS_H
+#define POSE_LS_H
+
+#include "numeric.h"
+
+namespace ls {
+    /**
+     * @brief Below this rotation (radians) exp/log use Taylor series instead of trig.
+     * At a 10ms tick this covers turning at up to ~5 rad/s, so most ticks never call sin/cos.
+     * The series are taken far enough that the error at this size is below double precision.
+     */
+    constexpr double SMALL_ANGLE = 0.05;
+
+    /**
+     * @brief A velocity/displacement in a pose's own frame, the tangent space of SE(2).
+     */
+    template<typename T>
+    struct Twist2 {
+        T dx;
+        T dy;
+        T dtheta; // in radians
+    };
+
+    /**
+     * @brief A 2D rotation stored as (cos, sin), so composing rotations needs no trig.
+     */
+    template<typename T>
+    struct Rot2 {
+        T c = T(1);
+        T s = T(0);
+
+        static Rot2 fromAngle(T radians) {
+            Rot2 r;
+            Numeric<T>::sincos(radians, r.s, r.c);
+            return r;
+        }
+
+        /**
+         * @brief Returns the rotation angle in (-pi, pi].
+         */
+        T angle() const {
+            return Numeric<T>::atan2(s, c);
+        }
+
+        constexpr Rot2 operator*(const Rot2& other) const {
+            return {c * other.c - s * other.s, s * other.c + c * other.s};
+        }
+
+        constexpr Rot2 inverse() const {
+            return {c, -s};
+        }
+
+        /**
+         * @brief Rotates a vector by this rotation.
+         */
+        constexpr void rotate(T x, T y, T& outX, T& outY) const {
+            outX = c * x - s * y;
+            outY = s * x + c * y;
+        }
+
+        /**
+         * @brief Pulls (c, s) back onto the unit circle after many compositions.
+         * One Newton step, enough since the drift per composition is tiny.
+         */
+        constexpr Rot2 normalized() const {
+            const T k = (T(3) - (c * c + s * s)) / T(2);
+            return {c * k, s * k};
+        }
+    };
+
+    /**
+     * @brief A rigid transform in 2D (an element of SE(2)).
+     */
+    template<typename T>
+    struct Pose2 {
+        T x = T(0);
+        T y = T(0);
+        Rot2<T> rotation;
+
+        /**
+         * @brief Returns the heading in (-pi, pi].
+         */
+        T theta() const {
+            return rotation.angle();
+        }
+
+        /**
+         * @brief Composes two poses: applies 'other' in the frame of this pose.
+         */
+        constexpr Pose2 operator*(const Pose2& other) const {
+            T rx, ry;
+            rotation.rotate(other.x, other.y, rx, ry);
+            return {x + rx, y + ry, rotation * other.rotation};
+        }
+
+        constexpr Pose2 inverse() const {
+            const Rot2<T> inv = rotation.inverse();
+            T rx, ry;
+            inv.rotate(x, y, rx, ry);
+            return {-rx, -ry, inv};
+        }
+
+        /**
+         * @brief The exponential map: the pose reached by moving along 'twist' at constant velocity for one unit of time.
+         * This is exactly the arc odometry assumes the robot drove over one update.
+         *
+         * @param twist the motion in the starting frame.
+         */
+        static Pose2 exp(const Twist2<T>& twist) {
+            const T w = twist.dtheta;
+            T sinW, cosW, a, b; // a = sin(w)/w, b = (1 - cos(w))/w
+            if (Numeric<T>::abs(w) < T(SMALL_ANGLE)) {
+                const T w2 = w * w;
+                a = T(1) - w2 / T(6) * (T(1) - w2 / T(20) * (T(1) - w2 / T(42)));
+                b = w / T(2) * (T(1) - w2 / T(12) * (T(1) - w2 / T(30) * (T(1) - w2 / T(56))));
+                sinW = w * a;
+                cosW = T(1) - w * b;
+            } else {
+                Numeric<T>::sincos(w, sinW, cosW);
+                a = sinW / w;
+                b = (T(1) - cosW) / w;
+            }
+            return {a * twist.dx - b * twist.dy, b * twist.dx + a * twist.dy, Rot2<T>{cosW, sinW}};
+        }
+
+        /**
+         * @brief The logarithm map, inverse of exp(): the constant twist that reaches this pose.
+         */
+        Twist2<T> log() const {
+            const T w = theta();
+            T a, b;
+            if (Numeric<T>::abs(w) < T(SMALL_ANGLE)) {
+                const T w2 = w * w;
+                a = T(1) - w2 / T(6) * (T(1) - w2 / T(20) * (T(1) - w2 / T(42)));
+                b = w / T(2) * (T(1) - w2 / T(12) * (T(1) - w2 / T(30) * (T(1) - w2 / T(56))));
+            } else {
+                a = rotation.s / w;
+                b = (T(1) - rotation.c) / w;
+            }
+            // invert [a -b; b a]
+            const T det = a * a + b * b;
+            return {(a * x + b * y) / det, (a * y - b * x) / det, w};
+        }
+    };
+}
+
+#endif // POSE_LS_H
@@ -0,0 +1,79 @@
+/*
+* Contains the trapezoidal motion profile used to move mechanisms (arms, lifts) between positions.
+* A profile is solved once per move, sampling it is a few multiplies.
+*/
+#ifndef PROFILE_LS_H
+#define PROFILE_LS_H
+
+namespace ls {
+    /**
+     * @brief Limits of a profile, in the units of the positions (ex. degrees, deg/s, deg/s²).
+     */
+    struct ProfileConstraints {
+        double maxVelocity;
+        double maxAcceleration;
+    };
+
+    /**
+     * @brief Where the profile wants the mechanism at some time.
+     */
+    struct ProfileState {
+        double position = 0;
+        double velocity = 0;
+        double acceleration = 0;
+    };
+
+    /**
+     * @brief Accelerates, cruises at the max velocity and decelerates to stop exactly on the goal.
+     * Short moves never reach the max velocity and become a triangle.
+     */
+    class TrapezoidProfile {
+        public:
+            /**
+             * @brief Construct a profile that stays at 0.
+             */
+            TrapezoidProfile() = default;
+
+            /**
+             * @brief Construct a new Trapezoid Profile object
+             *
+             * @param constraints the max velocity and acceleration, both positive.
+             * @param start the start position.
+             * @param goal the goal position.
+             * @param startVelocity the velocity at the start, ex. when a move replaces one that was still running.
+             * Only the part towards the goal is kept, and a start too fast to stop in time decelerates harder than the limit.
+             * @throws std::invalid_argument if a constraint is not positive.
+             */
+            TrapezoidProfile(ProfileConstraints constraints, double start, double goal, double startVelocity = 0);
+
+            /**
+             * @brief Gets the wanted state at a time, the goal (at rest) once the profile is over.
+             *
+             * @param t time since the start in seconds.
+             */
+            ProfileState sample(double t) const;
+
+            /**
+             * @brief Gets how long the move takes in seconds.
+             */
+            double getDuration() const;
+
+            /**
+             * @brief Gets the goal position.
+             */
+            double getGoal() const;
+        private:
+            double start = 0;
+            double goal = 0;
+            double direction = 1;
+            double startVelocity = 0; // towards the goal
+            double peakVelocity = 0;
+            double acceleration = 0;
+            double deceleration = 0;
+            double accelTime = 0;
+            double cruiseTime = 0;
+            double decelTime = 0;
+    };
+}
+
+#endif // PROFILE_LS_H
@@ -0,0 +1,37 @@
+/*
+* Contains the VEXlink radio transport of the alliance link (see alliancelink.h).
+*/
+#ifndef RADIOTRANSPORT_LS_H
+#define RADIOTRANSPORT_LS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "alliancelink.h"
+#include "api.h"
+
+namespace ls {
+    /**
+     * @brief Sends and receives raw bytes over a second V5 radio with pros::Link.
+     * Raw mode has no framing or checksum of its own, AllianceLink adds both.
+     */
+    class RadioTransport : public LinkTransport {
+        public:
+            /**
+             * @brief Construct a new Radio Transport object
+             *
+             * @param port the smart port of the radio.
+             * @param id the link name, the same on both robots.
+             * @param transmitter one robot of the pair is the transmitter and the other the receiver, data flows both ways.
+             */
+            RadioTransport(std::uint8_t port, const char* id, bool transmitter);
+
+            bool connected() override;
+            std::size_t send(const std::uint8_t* data, std::size_t size) override;
+            std::size_t available() override;
+            std::size_t receive(std::uint8_t* dest, std::size_t size) override;
+        private:
+            pros::Link link;
+    };
+}
+
+#endif // RADIOTRANSPORT_LS_H
@@ -0,0 +1,103 @@
+/*
+* Contains the per tick sensor snapshot shared by odom and controllers.
+* Every registered sensor is read back to back at the start of a tick, so all consumers
+* see the same moment in time instead of each reading its own sensors at different points.
+*/
+#ifndef SENSORFRAME_LS_H
+#define SENSORFRAME_LS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "api.h"
+#include "tracking.h"
+
+namespace ls {
+    /**
+     * @brief One snapshot of every registered sensor, indexed by the handles SensorSampler hands out.
+     */
+    struct SensorFrame {
+        static constexpr std::size_t MAX_WHEELS = 8;
+        static constexpr std::size_t MAX_IMUS = 2;
+
+        std::uint32_t sequence = 0; // counts up every sample(), 0 before the first one
+        std::uint64_t startTime = 0; // pros::micros() before the first read
+        std::uint64_t endTime = 0; // pros::micros() after the last read
+        std::array<double, MAX_WHEELS> distances{}; // in inches
+        std::array<double, MAX_IMUS> rotations{}; // in degrees
+
+        /**
+         * @brief Gets the time the frame represents, halfway through the reads.
+         * @return the time in microseconds.
+         */
+        std::uint64_t getTimestamp() const {
+            return startTime + (endTime - startTime) / 2;
+        }
+
+        /**
+         * @brief Gets how long the reads took, the most any two samples in this frame can be apart.
+         * @return the time in microseconds.
+         */
+        std::uint64_t getSkew() const {
+            return endTime - startTime;
+        }
+    };
+
+    /**
+     * @brief Reads a set of sensors into one SensorFrame per tick.
+     * Call sample() once at the start of the tick and pass the frame to everything that needs it.
+     */
+    class SensorSampler {
+        public:
+            using Handle = std::uint8_t;
+
+            /**
+             * @brief Registers a tracking wheel. Registering the same wheel again returns the same handle.
+             * The wheel must outlive this sampler.
+             *
+             * Takes a TrackingWheel or any BasicTrackingWheel, the latter is read without going through the variant.
+             *
+             * @param wheel the wheel to read.
+             * @return the index of its distance in SensorFrame::distances.
+             * @throws std::out_of_range if there are already MAX_WHEELS wheels.
+             */
+            template<typename Wheel>
+            Handle addWheel(Wheel& wheel) {
+                return addWheel(&wheel, [](const void* w) { return static_cast<const Wheel*>(w)->getLinearDistance(); });
+            }
+
+            /**
+             * @brief Registers an IMU. Registering the same IMU again returns the same handle.
+             * The IMU must outlive this sampler.
+             *
+             * @param imu the IMU to read.
+             * @return the index of its rotation in SensorFrame::rotations.
+             * @throws std::out_of_range if there are already MAX_IMUS IMUs.
+             */
+            Handle addImu(pros::Imu& imu);
+
+            /**
+             * @brief Reads every registered sensor back to back into a new frame.
+             * @return the new frame, valid until the next sample().
+             */
+            const SensorFrame& sample();
+
+            /**
+             * @brief Gets the last frame without reading anything.
+             * @return the last frame.
+             */
+            const SensorFrame& getFrame() const;
+        private:
+            using WheelReader = double(*)(const void*);
+            Handle addWheel(const void* wheel, WheelReader read);
+
+            std::array<const void*, SensorFrame::MAX_WHEELS> wheels{};
+            std::array<WheelReader, SensorFrame::MAX_WHEELS> readers{};
+            std::array<pros::Imu*, SensorFrame::MAX_IMUS> imus{};
+            std::uint8_t wheelCount = 0;
+            std::uint8_t imuCount = 0;
+            SensorFrame frame;
+    };
+}
+
+#endif // SENSORFRAME_LS_H
@@ -0,0 +1,74 @@
+/*
+* Contains the motor stall detector used by mechanisms that can jam (intakes, conveyors).
+* Works on values already in the motor state cache, so detecting a jam costs no device reads.
+*/
+#ifndef STALL_LS_H
+#define STALL_LS_H
+
+#include <cstdint>
+
+namespace ls {
+    /**
+     * @brief Settings for StallDetector.
+     */
+    struct StallConfig {
+        float freeSpeed = 200; // in rpm, speed at 12V with no load, for the gearset the motors are set to
+        float speedRatio = 0.25f; // bogged down below this fraction of the speed the voltage should give
+        float stallCurrent = 1800; // in mA at 12V (scaled with the voltage), bogged down only while drawing at least this
+        float minVoltage = 3; // in volts, smaller commands are not checked
+        std::uint32_t spinUpTime = 150; // in ms after a start or a direction change before checking
+        std::uint32_t stallTime = 60; // in ms of being bogged down before it counts as a stall
+    };
+
+    /**
+     * @brief Where the detector is.
+     */
+    enum class StallState : std::uint8_t {
+        Idle, // the command is under minVoltage
+        SpinUp, // just started, not checked yet
+        Running,
+        Suspect, // bogged down, but not for stallTime yet
+        Stalled // stays until reset()
+    };
+
+    /**
+     * @brief Finds a jammed motor by comparing its speed with the speed its commanded voltage should give, and its current.
+     * A motor that is slow but draws little is only lightly loaded, one that is slow and draws a lot is jammed.
+     */
+    class StallDetector {
+        public:
+            /**
+             * @brief Construct a new Stall Detector object
+             * @param config the thresholds.
+             */
+            explicit StallDetector(StallConfig config = {});
+
+            /**
+             * @brief Steps the detector, call once per tick with fresh measurements.
+             *
+             * @param volts the commanded voltage [-12, 12].
+             * @param rpm the measured velocity, in rpm.
+             * @param current the measured current, in mA.
+             * @param dt time since the last update in seconds.
+             * @return the new state.
+             */
+            StallState update(float volts, float rpm, float current, float dt);
+
+            /**
+             * @brief Gets the state of the last update.
+             */
+            StallState getState() const;
+
+            /**
+             * @brief Back to Idle, ex. once the jam has been handled.
+             */
+            void reset();
+        private:
+            StallConfig config;
+            StallState state = StallState::Idle;
+            float timer = 0; // in seconds, time in the current state
+            std::int8_t direction = 0;
+    };
+}
+
+#endif // STALL_LS_H
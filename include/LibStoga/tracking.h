@@ -7,37 +7,237 @@
 
 #include "api.h"
 #include <cstdint>
+#include <variant>
+#include "geometry.h"
+#include "velocity.h"
 
 namespace ls {
     /*
-    * Wrapper class for pros::Rotation.
-    * Used extensively for Odom wheels.
+    * Sensor backends for BasicTrackingWheel.
+    * Each one stores its device inline and reads it in raw ticks, TICKS_PER_REV of them per wheel revolution.
+    * Backends with HAS_VELOCITY report their own velocity (ticks/s), the others are estimated from position.
     */
-    class TrackingWheel {
-    private:
-        double radius;
-        double conversion_factor;
 
-        std::unique_ptr<pros::adi::Encoder> encoder;
-        std::unique_ptr<pros::Rotation> rotation;
+    /**
+     * @brief V5 Rotation sensor, read in centidegrees.
+     */
+    struct RotationBackend {
+        static constexpr double TICKS_PER_REV = 36000;
+        static constexpr bool HAS_VELOCITY = true;
+
+        pros::Rotation device;
+
+        /**
+         * @param port the smart port [1,21], negative if reversed.
+         */
+        explicit RotationBackend(std::int8_t port): device(port) {
+            device.set_data_rate(5);
+        }
+        double position() const { return device.get_position(); }
+        double velocity() const { return device.get_velocity(); }
+        void reverse() { device.reverse(); }
+    };
+
+    /**
+     * @brief ADI (3-wire) quadrature encoder, read in degrees.
+     */
+    struct AdiEncoderBackend {
+        static constexpr double TICKS_PER_REV = 360;
+        static constexpr bool HAS_VELOCITY = false;
+
+        pros::adi::Encoder device;
+        double sign;
+
+        /**
+         * @param top the upper ADI port.
+         * @param bottom the lower ADI port.
+         * @param reversed if is reversed by default.
+         */
+        AdiEncoderBackend(std::uint8_t top, std::uint8_t bottom, bool reversed = false)
+            : device(top, bottom), sign(reversed ? -1 : 1) {}
+        double position() const { return sign * device.get_value(); }
+        double velocity() const { return 0; }
+        // flips the sign instead of rebuilding the encoder, which would lose its count.
+        void reverse() { sign = -sign; }
+    };
+
+    /**
+     * @brief The integrated encoder of a V5 motor, read in degrees.
+     */
+    struct MotorBackend {
+        static constexpr double TICKS_PER_REV = 360;
+        static constexpr bool HAS_VELOCITY = true;
+
+        pros::Motor device;
+
+        /**
+         * @param port the smart port [1,21], negative if reversed.
+         */
+        explicit MotorBackend(std::int8_t port): device(port, pros::v5::MotorGears::invalid, pros::v5::MotorUnits::degrees) {}
+        double position() const { return device.get_position(); }
+        double velocity() const { return device.get_actual_velocity() * 6; } // rpm to degrees/s
+        void reverse() { device.set_reversed(!device.is_reversed()); }
+    };
+
+    /**
+     * @brief A simulated encoder, whatever is written with set() is read back. Read in degrees.
+     */
+    struct SimBackend {
+        static constexpr double TICKS_PER_REV = 360;
+        static constexpr bool HAS_VELOCITY = false;
+
+        double value = 0;
+        double sign = 1;
+
+        explicit SimBackend(double start = 0): value(start) {}
+        void set(double degrees) { value = degrees; }
+        double position() const { return sign * value; }
+        double velocity() const { return 0; }
+        void reverse() { sign = -sign; }
+    };
+
+    /**
+     * @brief A tracking wheel on a known sensor type, no virtual calls, null checks or heap.
+     * With a constant Radius (> 0) the distance per tick is a compile time constant,
+     * otherwise it is given to the constructor and can be changed with setRadius().
+     *
+     * @tparam Backend one of RotationBackend, AdiEncoderBackend, MotorBackend or SimBackend.
+     * @tparam Radius the wheel radius in inches if fixed at compile time, 0 if given at runtime.
+     */
+    template<typename Backend, double Radius = 0.0>
+    class BasicTrackingWheel {
+        public:
+            static constexpr bool FIXED_RADIUS = Radius > 0;
+
+            /**
+             * @brief Distance traveled per tick for a wheel of the given radius.
+             * @param radius the wheel radius in inches.
+             */
+            static constexpr double distancePerTick(double radius) {
+                return TAU * radius / Backend::TICKS_PER_REV;
+            }
 
-        std::int8_t port_upper = 0, port_lower = 0;
-        bool reversed = false;
+            /**
+             * @brief Construct a new Tracking Wheel with the radius given at compile time.
+             * @param backend the sensor.
+             */
+            explicit BasicTrackingWheel(Backend backend) requires FIXED_RADIUS
+                : backend(std::move(backend)) {}
+
+            /**
+             * @brief Construct a new Tracking Wheel.
+             * @param backend the sensor.
+             * @param radius radius of the wheel attached in inches.
+             */
+            explicit BasicTrackingWheel(Backend backend, double radius = 2.75) requires (!FIXED_RADIUS)
+                : backend(std::move(backend)), conversion_factor(distancePerTick(radius)) {}
+
+            /**
+            * @brief reverses the wheel direction.
+            */
+            void reverse() {
+                backend.reverse();
+            }
+
+            /**
+            * @brief Gets the linear speed of this wheel in in/s.
+            * Sensors that cannot measure velocity estimate it from the samples taken by each call of this method.
+            * Does not affect getLinearDeltaDistance().
+            */
+            double getLinearSpeed() {
+                if constexpr (Backend::HAS_VELOCITY) {
+                    return backend.velocity() * getDistancePerTick();
+                } else {
+                    sample(speed);
+                    return speed.getVelocity();
+                }
+            }
+
+            /**
+            * @brief Gets the displacement of this wheel in inches.
+            */
+            double getLinearDistance() const {
+                return backend.position() * getDistancePerTick();
+            }
+
+            /**
+            * @brief Gets the change in distance of this wheel since the last call of this function, in inches.
+            */
+            double getLinearDeltaDistance() {
+                const double latest = getLinearDistance();
+                const double tor = latest - prev_distance;
+                prev_distance = latest;
+                return tor;
+            }
+
+            /**
+            * @brief Feeds the current distance, timestamped with pros::micros(), into the given estimator.
+            * @param estimator the estimator to update.
+            */
+            void sample(VelocityEstimator& estimator) const {
+                estimator.update(getLinearDistance(), pros::micros());
+            }
+
+            /**
+            * @brief Set the radius of this wheel, only when the radius is not fixed at compile time.
+            * @param wheel_radius new radius in inches.
+            */
+            void setRadius(double wheel_radius) requires (!FIXED_RADIUS) {
+                conversion_factor = distancePerTick(wheel_radius);
+            }
+
+            /**
+            * @brief Gets the inches traveled per sensor tick.
+            */
+            double getDistancePerTick() const {
+                if constexpr (FIXED_RADIUS) {
+                    return distancePerTick(Radius);
+                } else {
+                    return conversion_factor;
+                }
+            }
+
+            /**
+            * @brief Gets the sensor, ex. to set() a SimBackend.
+            */
+            Backend& getBackend() {
+                return backend;
+            }
+        private:
+            Backend backend;
+            double conversion_factor = distancePerTick(Radius);
+            double prev_distance = 0;
+            VelocityEstimator speed; // only used by getLinearSpeed() when the sensor has no velocity
+    };
+
+    /*
+    * Wrapper class for any of the tracking wheel backends, for code that has to pick the sensor at runtime.
+    * Used extensively for Odom wheels.
+    * The wheel is stored inline (std::variant), so there is still no heap or virtual call, only a switch on the type.
+    */
+    class TrackingWheel {
     public:
+        using Variant = std::variant<
+            BasicTrackingWheel<RotationBackend>,
+            BasicTrackingWheel<AdiEncoderBackend>,
+            BasicTrackingWheel<MotorBackend>,
+            BasicTrackingWheel<SimBackend>>;
+
         /**
          * @brief Construct a new Tracking Wheel object
          * This will construct as a pros::Rotation object.
-         * 
-         * @param port the smart port [1,24] to connect
+         *
+         * @param port the smart port [1,21] to connect
          * @param radius radius of the wheel attached
          * @param reversed if is reversed by default
+         * @throws std::invalid_argument if the port is not a smart port.
          */
         explicit TrackingWheel(std::uint8_t port, double radius=2.75, bool reversed=false);
 
         /**
          * @brief Construct a new Tracking Wheel object
          * This will construct as a pros::ADIEncoder object.
-         * 
+         *
          * @param port_upper the upper port
          * @param port_lower the lower port
          * @param radius radius of the wheel attached
@@ -45,11 +245,18 @@ namespace ls {
          */
         explicit TrackingWheel(std::uint8_t port_upper, std::uint8_t port_lower, double radius=2.75, bool reversed=false);
 
+        /**
+         * @brief Construct a new Tracking Wheel object from a wheel of any backend.
+         *
+         * @param wheel the wheel to wrap.
+         */
+        template<typename Backend>
+        explicit TrackingWheel(BasicTrackingWheel<Backend> wheel): wheel(std::move(wheel)) {}
+
         /**
          * @brief Construct a new Tracking Wheel object
          * Takes the configurations from the 'other' tracking wheel and puts them into this.
-         * Will erase all configurations from 'other' in the proccess.
-         * 
+         *
          * @param other the other to pull configurations from.
          */
         explicit TrackingWheel(TrackingWheel& other);
@@ -57,42 +264,56 @@ namespace ls {
         /**
         * @brief reverses the wheel direction.
         */
-        virtual void reverse();
+        void reverse();
 
         /**
         * @brief Gets the linear speed of this TrackingWheel.
         * Depending on rotary encoder it will output a linear speed in in/s
-        * 
+        * ADI encoders have no velocity reading, so it is estimated from the samples taken by each call of this method.
+        * Does not affect getLinearDeltaDistance().
+        *
         * @returns Linear speed of this encoder.
         */
-        virtual double getLinearSpeed();
+        double getLinearSpeed();
 
         /**
         * @brief Gets the displacement of this TrackingWheel.
-        * Will change depending on radius. 
-        * 
-        * @returns Displacement in '(in) 
+        * Will change depending on radius.
+        *
+        * @returns Displacement in '(in)
         */
-        virtual double getLinearDistance();
+        double getLinearDistance() const;
 
         /**
         * @brief Gets the change in distance of this tracking wheel since the last call of this function.
         * Will change depending on radius.
-        * 
+        *
         * @returns change in distance in '(in)
         */
-        virtual double getLinearDeltaDistance();
+        double getLinearDeltaDistance();
+
+        /**
+        * @brief Feeds the current distance, timestamped with pros::micros(), into the given estimator.
+        * Each consumer that needs velocity/acceleration should keep its own estimator and call this once per loop.
+        *
+        * @param estimator the estimator to update.
+        */
+        void sample(VelocityEstimator& estimator) const;
 
         /**
         * @brief Set the radius of this TrackingWheel object.
-        * 
+        *
         * @param wheel_radius new radius in '(in)
         */
-        virtual void setRadius(double wheel_radius);
+        void setRadius(double wheel_radius);
+
+        /**
+        * @brief Gets the wrapped wheel, to reach the backend directly.
+        */
+        Variant& getWheel();
     private:
-        double prev_distance = 0;
-        long double prev_time = 0;
+        Variant wheel;
     };
 }
 
-#endif // TRACKING_H
\ No newline at end of file
+#endif // TRACKING_H
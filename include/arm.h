@@ -0,0 +1,141 @@
+#ifndef ARM_HS_H
+#define ARM_HS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "api.h"
+#include "LibStoga/command.h"
+#include "LibStoga/feedforward.h"
+#include "LibStoga/pid.h"
+#include "LibStoga/profile.h"
+#include "robotconfig.h"
+
+/**
+ * @brief The positions the arm is moved between.
+ */
+enum class ArmPreset : std::uint8_t {
+    Load, // under the conveyor, takes a ring
+    Hold, // up out of the way, ring kept
+    Score // over the wall stake
+};
+
+/**
+ * @brief Tuning of the wall stake arm. Angles are in degrees from horizontal, positive up.
+ */
+struct ArmSettings {
+    float loadAngle = -40;
+    float holdAngle = 20;
+    float scoreAngle = 130;
+    ls::ProfileConstraints constraints{360, 1800}; // in deg/s and deg/s²
+    ls::ArmFeedforward feedforward{0.3, 1.0, 0.015, 0.0005}; // in volts, kG at cos(radians), kV per deg/s, kA per deg/s²
+    float kP = 0.3f; // in volts per degree of error from the profile
+    float kI = 0;
+    float kD = 1.5f;
+    float tolerance = 1.5f; // in degrees
+    float velocityTolerance = 10; // in deg/s
+    std::uint32_t settleTime = 40; // in ms inside both tolerances before the move counts as done
+    std::uint32_t period = 10; // in ms between control updates
+};
+
+/**
+ * @brief The wall stake arm: motors on a pivot with a rotation sensor on the pivot.
+ *
+ * Every move follows a trapezoid profile from where the arm is (or where the last move wanted it) to the goal.
+ * A task running at a fixed rate outputs gravity and motion feedforward for the profile's state, with PID on the
+ * error from it, so the PID only corrects and the arm does not overshoot. The task writes the motors itself,
+ * they are not in the MotorCommandBuffer that is flushed by the control loop.
+ */
+class Arm {
+private:
+    pros::MotorGroup motors;
+    pros::Rotation sensor;
+    float restAngle; // in degrees, where the arm is when the sensor is reset
+    ArmSettings settings;
+    ls::PID pid;
+
+    // under the mutex.
+    ls::TrapezoidProfile profile;
+    std::uint32_t moveStart = 0; // pros::millis() of the start of the move
+    std::uint32_t settleSince = 0; // pros::millis() since the arm is inside the tolerances, 0 if it is not
+
+    std::atomic<float> angle = 0;
+    std::atomic<bool> settled = true;
+    std::atomic<std::uint32_t> settleDuration = 0;
+
+    pros::Mutex mutex;
+    std::unique_ptr<pros::Task> task = nullptr;
+    std::atomic<bool> running = false;
+
+    /**
+     * @brief One control update, runs in the task.
+     */
+    void update(std::uint32_t now);
+public:
+    /**
+     * @brief Construct a new Arm object on the arm ports of the config
+     *
+     * @param config the ports and the rest angle, must outlive the arm.
+     * @param settings the presets and tuning.
+     */
+    explicit Arm(const RobotConfig& config = robotConfig(), ArmSettings settings = {});
+    ~Arm();
+
+    /**
+     * @brief Resets the sensor to the rest angle, the arm must be resting when this runs.
+     */
+    void initialize();
+
+    /**
+     * @brief Starts the control task, holding the arm where it is.
+     */
+    void start();
+
+    /**
+     * @brief Stops the control task and the motors.
+     */
+    void stop();
+
+    /**
+     * @brief Starts a move to an angle, replacing any move in progress without a jump in velocity.
+     *
+     * @param degrees the goal in degrees from horizontal.
+     */
+    void moveTo(float degrees);
+
+    /**
+     * @brief Starts a move to a preset.
+     *
+     * @param preset the preset.
+     */
+    void moveTo(ArmPreset preset);
+
+    /**
+     * @brief Gets the angle of the last control update, in degrees from horizontal.
+     */
+    float getAngle() const;
+
+    /**
+     * @brief Gets the goal of the current move, in degrees from horizontal.
+     */
+    float getTarget();
+
+    /**
+     * @brief Returns if the last move has settled on its goal.
+     */
+    bool isSettled() const;
+
+    /**
+     * @brief Gets how long the last settled move took, from its start until the arm stayed inside the tolerances, in ms.
+     */
+    std::uint32_t getSettleTime() const;
+
+    /**
+     * @brief Waits until the current move has settled.
+     *
+     * @param timeout max time to wait in ms, 0 for no timeout.
+     */
+    ls::Command waitSettled(std::uint32_t timeout = 0);
+};
+
+#endif // ARM_HS_H
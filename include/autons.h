@@ -0,0 +1,51 @@
+#ifndef AUTONS_HS_H
+#define AUTONS_HS_H
+
+#include <array>
+#include "LibStoga/alliancelink.h"
+#include "LibStoga/auton.h"
+#include "LibStoga/feedforward.h"
+#include "arm.h"
+#include "chassis.h"
+#include "clamp.h"
+#include "intake.h"
+
+/**
+ * @brief The drivetrain the routines drive with (defined in main.cpp).
+ */
+extern ls::MotionConfig drivetrain;
+extern Chassis chassis;
+extern Intake intake;
+extern Clamp clamp;
+extern Arm arm;
+/**
+ * @brief The link to the alliance partner (defined in main.cpp). Routines send it the end of each drive and wait
+ * while shouldYield(), see waitForRightOfWay() in autons.cpp.
+ */
+extern ls::AllianceLink allianceLink;
+/**
+ * @brief Drivetrain feedforward gains, loaded from the SD card at boot (defined in main.cpp).
+ * Only measured for now: drive(), turn() and Chassis don't use them yet, they drive on PID alone.
+ */
+extern ls::FeedforwardGains linearFF;
+extern ls::FeedforwardGains angularFF;
+
+// Routines (defined in autons.cpp):
+ls::Command autonDoNothing();
+ls::Command autonLeaveLine();
+ls::Command autonCharacterize();
+ls::Command autonClampGoal();
+
+/**
+ * @brief Every routine the selector can pick, the first one is the default.
+ */
+inline constexpr std::array<ls::AutonRoutine, 4> AUTON_ROUTINES = {{
+    {"Do Nothing", ls::AutonSide::Any, ls::AllianceColor::Any, autonDoNothing},
+    {"Leave Line", ls::AutonSide::Any, ls::AllianceColor::Any, autonLeaveLine},
+    {"Characterize", ls::AutonSide::Any, ls::AllianceColor::Any, autonCharacterize},
+    {"Clamp Goal", ls::AutonSide::Any, ls::AllianceColor::Any, autonClampGoal},
+}};
+
+static_assert(ls::validateAutonTable(AUTON_ROUTINES), "AUTON_ROUTINES has a missing or duplicate entry.");
+
+#endif // AUTONS_HS_H
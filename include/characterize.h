@@ -0,0 +1,43 @@
+#ifndef CHARACTERIZE_HS_H
+#define CHARACTERIZE_HS_H
+
+#include <cstdint>
+#include "LibStoga/command.h"
+#include "LibStoga/feedforward.h"
+#include "LibStoga/geometry.h"
+#include "chassis.h"
+
+/**
+ * @brief How hard and how far the characterization runs drive.
+ */
+struct CharacterizeSettings {
+    double rampRate = 0.5; // in V/s, how fast the quasistatic runs raise the voltage
+    double stepVoltage = 6; // in V, the voltage the dynamic runs jump to
+    double maxDistance = 48; // in inches, a linear run stops after this much wheel travel
+    double maxRotation = 4 * ls::PI; // in radians, a turning run stops after this much rotation
+    std::uint32_t quasistaticTime = 10000; // in ms, longest quasistatic run
+    std::uint32_t dynamicTime = 1500; // in ms, longest dynamic run
+    std::uint32_t restTime = 1000; // in ms, time to let the robot stop between runs
+};
+
+/**
+ * @brief Measures the drive's feedforward gains.
+ *
+ * Runs a quasistatic ramp (slow voltage increase, so acceleration is ~0 and kS/kV stand out) and a dynamic step
+ * (sudden voltage, so kA stands out), forwards and backwards, first driving straight and then turning in place.
+ * Voltage, velocity and acceleration are logged every tick from the motor state cache, then written to
+ * CHARACTERIZE_LOG_FILE as CSV and fitted by least squares. The gains are saved to FEEDFORWARD_FILE.
+ * tools/fit_feedforward refits the CSV on a computer.
+ *
+ * This is data collection for now: the motion code does not feed the gains forward yet.
+ *
+ * Needs the chassis attached to a state cache that is refreshed every tick, and about maxDistance of clear field.
+ *
+ * @param chassis the drive to characterize.
+ * @param linear where the linear gains are written (volts per in/s, per in/s^2).
+ * @param angular where the angular gains are written (volts per rad/s, per rad/s^2).
+ * @param settings the run lengths and voltages.
+ */
+ls::Command characterizeDrive(Chassis& chassis, ls::FeedforwardGains& linear, ls::FeedforwardGains& angular, CharacterizeSettings settings = {});
+
+#endif // CHARACTERIZE_HS_H
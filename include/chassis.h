@@ -1,55 +1,226 @@
 #ifndef CHASSIS_HS_H
 #define CHASSIS_HS_H
 
+#include <cstdint>
 #include <vector>
-#include "odom.h"
+#include "api.h"
+#include "LibStoga/drive.h"
+#include "LibStoga/motorcommand.h"
+#include "LibStoga/motormonitor.h"
+#include "LibStoga/motorstate.h"
+#include "LibStoga/odom.h"
+#include "robotconfig.h"
+
+/**
+ * @brief Averaged state of one side of the drive, read from the motor state cache.
+ */
+struct DriveSide {
+    float position = 0; // in inches of wheel travel
+    float speed = 0; // in in/s
+    float current = 0; // in mA
+    float voltage = 0; // in volts
+};
 
 class Chassis {
 private:
-    pros::MotorGroup* left;
-    pros::MotorGroup* right;
-    bool is_auton;
+    const RobotConfig& config;
+    DriveGeometry geometry;
+
+    pros::MotorGroup left;
+    pros::MotorGroup right;
+    ls::MotorCommandBuffer& commands;
+    ls::MotorCommandBuffer::Handle leftHandle;
+    ls::MotorCommandBuffer::Handle rightHandle;
+
+    ls::JoystickCurve throttleCurve;
+    ls::JoystickCurve turnCurve;
+    float turnSensitivity = 1; // how sharp curvature drive turns at full throttle
+    float quickTurnThreshold = 0.05f; // below this throttle, curvature drive turns in place
 
-    Odom odom;
+    ls::SlewLimiter leftSlew;
+    ls::SlewLimiter rightSlew;
+    ls::TractionControl leftTraction;
+    ls::TractionControl rightTraction;
+    std::uint64_t lastOutput = 0; // pros::micros() of the last output
+
+    ls::MotorStateCache* states = nullptr;
+    ls::MotorStateCache::Handle leftState = 0;
+    ls::MotorStateCache::Handle rightState = 0;
+
+    const ls::MotorMonitor* monitor = nullptr;
+    ls::MotorMonitor::Handle leftHealth = 0;
+    ls::MotorMonitor::Handle rightHealth = 0;
+
+    /**
+     * @brief Averages the motors of one side from the state cache.
+     */
+    DriveSide readSide(ls::MotorStateCache::Handle first, std::int8_t size) const;
+
+    /**
+     * @brief Sets powers in [-1, 1] for both sides as voltages, sent on the next commands.flush().
+     * Goes through desaturation, then the slew limiters, then traction control.
+     */
+    void output(float leftPower, float rightPower);
 public:
 
     /**
-     * @brief Construct a new Chassis object
-     * 
+     * @brief Construct a new Chassis object on the ports and wheel sizes of the config
+     *
      * Note that this is a normal tank drive (as of now)
+     * Motor commands are only sent when 'commands' is flushed.
+     *
+     * @param commands the buffer motor commands go through.
+     * @param config the ports and measurements, must outlive the chassis.
      */
-    Chassis();
-    
+    explicit Chassis(ls::MotorCommandBuffer& commands, const RobotConfig& config = robotConfig());
+
     /**
-     * @brief Initializes all the motors and rotations in this class as neccessary. 
+     * @brief Initializes all the motors and rotations in this class as neccessary.
      */
     void initialize();
 
     /**
-     * @brief Stops all running chassis motors. 
-     * 
+     * @brief Stops all running chassis motors.
+     *
      * Braking will depend on the brake mode of motors defined during initialize()
      */
     void stopAllMotors();
 
+    /**
+     * @brief Sets the joystick curves used by the driver control methods.
+     *
+     * @param throttle curve for forwards/backwards (and both sticks in tank).
+     * @param turn curve for turning.
+     */
+    void setCurves(const ls::JoystickCurve& throttle, const ls::JoystickCurve& turn);
+
+    /**
+     * @brief Sets how curvature drive turns.
+     *
+     * @param sensitivity how sharp it turns at full throttle.
+     * @param quickTurn below this throttle [0, 1] it turns in place like arcade.
+     */
+    void setCurvature(float sensitivity, float quickTurn);
+
+    /**
+     * @brief Sets how fast the power of each side can change.
+     *
+     * @param accelRate largest increase in power per second, full power is 1.
+     * @param decelRate largest decrease in power per second.
+     */
+    void setSlew(float accelRate, float decelRate);
+
+    /**
+     * @brief Sets the slip thresholds and back off rates of traction control.
+     *
+     * @param config the new settings.
+     */
+    void setTraction(const ls::TractionConfig& config);
+
+    /**
+     * @brief Registers the drive motors with the state cache traction control reads wheel speed and current from.
+     *
+     * @param cache the cache, refreshed every tick by its owner.
+     */
+    void attach(ls::MotorStateCache& cache);
+
+    /**
+     * @brief Registers the drive motors with a motor monitor, and derates each side's output by its hottest motor's
+     * power scale, so a hot side loses power smoothly before the motors cut it themselves.
+     * moveVoltage() is not derated, it outputs exactly what it is given.
+     *
+     * @param monitor the monitor, must be started by its owner.
+     */
+    void attach(ls::MotorMonitor& monitor);
+
+    /**
+     * @brief Checks each side for wheel slip, call once per tick after the state cache and odom have updated.
+     * Does nothing before attach().
+     *
+     * @param odom gives the ground speed, from the tracking wheels.
+     * @param dt time the odom delta covers in seconds.
+     */
+    void updateTraction(ls::AbstractOdom& odom, double dt);
+
+    /**
+     * @brief Drives each side from its own stick.
+     *
+     * @param leftY the left Y analog value [-127, 127]
+     * @param rightY the right Y analog value [-127, 127]
+     */
+    void tank(std::int32_t leftY, std::int32_t rightY);
+
+    /**
+     * @brief Drives with one stick axis for throttle and one for turning.
+     *
+     * @param throttle the throttle analog value [-127, 127]
+     * @param turn the turn analog value [-127, 127]
+     */
+    void arcade(std::int32_t throttle, std::int32_t turn);
+
+    /**
+     * @brief Curvature (cheesy) drive: the turn stick sets the curvature of the path, not the turn rate,
+     * so the robot turns the same radius at any speed. Turns in place when the throttle is (near) zero.
+     *
+     * @param throttle the throttle analog value [-127, 127]
+     * @param turn the turn analog value [-127, 127]
+     * @param quickTurn turn in place regardless of throttle.
+     */
+    void curvature(std::int32_t throttle, std::int32_t turn, bool quickTurn = false);
+
     /**
      * @brief Moves the chassis based on analog values from opcontrol.
-     * 
+     *
      * As of now, PID or other algorithms do not stabalize this, it is purely driven
-     * by the driver.
-     * 
+     * by the driver. Uses curvature drive.
+     *
      * @param X the X analog value [-127, 127]
      * @param Y the Y analog value [-127, 127]
      */
     void op_move(std::int32_t X, std::int32_t Y);
 
     /**
-     * @brief Destroy the Chassis object
-     * 
+     * @brief Moves each side at the given power, used by autonomous motions.
+     *
+     * @param leftPower left side power [-127, 127]
+     * @param rightPower right side power [-127, 127]
+     */
+    void move(double leftPower, double rightPower);
+
+    /**
+     * @brief Sets the voltage of each side directly, skipping slew and traction control.
+     * Used when the exact voltage matters (ex. characterization), not for normal driving.
+     *
+     * @param leftVolts left side voltage [-12, 12]
+     * @param rightVolts right side voltage [-12, 12]
+     */
+    void moveVoltage(double leftVolts, double rightVolts);
+
+    /**
+     * @brief Gets the left side state as of the last state cache refresh, all 0 before attach().
      */
-    ~Chassis();
+    DriveSide getLeftState() const;
 
+    /**
+     * @brief Gets the right side state as of the last state cache refresh, all 0 before attach().
+     */
+    DriveSide getRightState() const;
+
+    /**
+     * @brief Gets the config the chassis was built from.
+     */
+    const RobotConfig& getConfig() const;
+
+    /**
+     * @brief Gets the left side motors.
+     */
+    pros::MotorGroup& getLeft();
+
+    /**
+     * @brief Gets the right side motors.
+     */
+    pros::MotorGroup& getRight();
 };
 
 
-#endif // CHASSIS_HS_H
\ No newline at end of file
+#endif // CHASSIS_HS_H
@@ -0,0 +1,138 @@
+#ifndef CLAMP_HS_H
+#define CLAMP_HS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "api.h"
+#include "LibStoga/command.h"
+
+/**
+ * @brief What the goal clamp is doing.
+ */
+enum class ClampState : std::uint8_t {
+    Open, // open and not watching for a goal
+    Armed, // open, closes by itself as soon as a goal is seated
+    Clamped
+};
+
+/**
+ * @brief Tuning of the goal clamp.
+ */
+struct ClampSettings {
+    std::int32_t seatDistance = 30; // in mm, a goal this close to the distance sensor is seated
+    std::uint8_t confirmSamples = 2; // seated readings in a row before clamping, so one noisy reading can't close it
+    std::uint32_t pollPeriod = 5; // in ms
+};
+
+/**
+ * @brief The mobile goal clamp: a piston and a sensor that sees when a goal is seated.
+ *
+ * A task polls the sensor every few ms and closes the clamp the moment a goal is seated while armed,
+ * so autonomous routines can drive into a goal and await the clamp instead of waiting a fixed time.
+ */
+class Clamp {
+private:
+    pros::adi::Pneumatics piston;
+    std::unique_ptr<pros::Distance> distance;
+    std::unique_ptr<pros::adi::DigitalIn> limitSwitch;
+    ClampSettings settings;
+
+    std::atomic<ClampState> state = ClampState::Open;
+    bool rearm = false; // arm again once the sensor no longer sees the released goal
+    std::uint8_t seatedCount = 0;
+    std::atomic<std::uint32_t> clampedAt = 0; // pros::millis() of the last clamp
+    std::atomic<std::uint32_t> clamps = 0;
+
+    pros::Mutex mutex;
+    std::unique_ptr<pros::Task> task = nullptr;
+    std::atomic<bool> running = false;
+
+    /**
+     * @brief Reads the sensor once.
+     */
+    bool readSeated();
+
+    /**
+     * @brief Polls the sensor and clamps, runs in the task.
+     */
+    void loop();
+public:
+    /**
+     * @brief Construct a new Clamp object that sees the goal with a distance sensor
+     *
+     * @param piston the three wire port of the clamp piston.
+     * @param distancePort the smart port of the distance sensor.
+     * @param settings the tuning.
+     */
+    Clamp(char piston, std::int8_t distancePort, ClampSettings settings = {});
+
+    /**
+     * @brief Construct a new Clamp object that sees the goal with a limit switch
+     *
+     * @param piston the three wire port of the clamp piston.
+     * @param limitSwitch the three wire port of the limit switch, pressed while a goal is seated.
+     * @param settings the tuning.
+     */
+    Clamp(char piston, char limitSwitch, ClampSettings settings = {});
+    ~Clamp();
+
+    /**
+     * @brief Starts the task that polls the sensor.
+     */
+    void start();
+
+    /**
+     * @brief Stops the task, the piston stays where it is.
+     */
+    void stop();
+
+    /**
+     * @brief Opens the clamp and closes it by itself once a goal is seated.
+     */
+    void arm();
+
+    /**
+     * @brief Closes the clamp now, seated or not.
+     */
+    void close();
+
+    /**
+     * @brief Opens the clamp. It arms again on its own once the released goal is gone from the sensor.
+     */
+    void release();
+
+    /**
+     * @brief Opens the clamp and stops watching for goals until arm().
+     */
+    void disarm();
+
+    /**
+     * @brief Gets what the clamp is doing.
+     */
+    ClampState getState() const;
+
+    /**
+     * @brief Returns if the clamp is closed.
+     */
+    bool isClamped() const;
+
+    /**
+     * @brief Gets when the clamp last closed, in ms since boot (pros::millis()).
+     */
+    std::uint32_t getClampedAt() const;
+
+    /**
+     * @brief Gets the number of times the clamp closed.
+     */
+    std::uint32_t getClamps() const;
+
+    /**
+     * @brief Waits until the clamp is closed, ex. racing a drive into a goal.
+     *
+     * @param timeout max time to wait in ms, 0 for no timeout.
+     */
+    ls::Command waitClamped(std::uint32_t timeout = 0);
+};
+
+#endif // CLAMP_HS_H
@@ -0,0 +1,148 @@
+#ifndef INTAKE_HS_H
+#define INTAKE_HS_H
+
+#include <atomic>
+#include <cstdint>
+#include "api.h"
+#include "LibStoga/motorcommand.h"
+#include "LibStoga/motormonitor.h"
+#include "LibStoga/motorstate.h"
+#include "LibStoga/stall.h"
+#include "robotconfig.h"
+
+/**
+ * @brief What the intake is doing.
+ */
+enum class IntakeState : std::uint8_t {
+    Stopped,
+    Running,
+    Unjamming // running backwards for a moment after a stall, then back to Running
+};
+
+/**
+ * @brief Counters of the intake since boot.
+ */
+struct IntakeStats {
+    std::uint32_t rings = 0;
+    std::uint32_t jams = 0;
+    float runTime = 0; // in seconds the intake was told to run
+    float unjamTime = 0; // in seconds spent reversing out of jams
+    float ringsPerMinute = 0; // rings over run time
+};
+
+/**
+ * @brief The intake and hook conveyor.
+ *
+ * Jams are found from the state cache the chassis already refreshes every tick (see ls::StallDetector),
+ * then the conveyor runs backwards for a moment and picks back up on its own.
+ */
+class Intake {
+private:
+    pros::MotorGroup motors;
+    ls::MotorCommandBuffer& commands;
+    ls::MotorCommandBuffer::Handle handle;
+
+    ls::MotorStateCache* states = nullptr;
+    ls::MotorStateCache::Handle stateHandle = 0;
+    const ls::MotorMonitor* monitor = nullptr;
+    ls::MotorMonitor::Handle healthHandle = 0;
+    ls::StallDetector stall;
+    float reverseVolts = 8;
+    float reverseTime = 0.15f; // in seconds
+
+    float wanted = 0; // in volts
+    IntakeState state = IntakeState::Stopped;
+    float unjamLeft = 0; // in seconds
+
+    std::atomic<std::uint32_t> rings = 0;
+    std::uint32_t jams = 0;
+    float runTime = 0;
+    float unjamTime = 0;
+
+    /**
+     * @brief Steps the stall detector on the cached motor state.
+     * @return if the conveyor just stalled.
+     */
+    bool checkStall(float volts, float dt);
+public:
+    /**
+     * @brief Construct a new Intake object on the intake ports of the config
+     *
+     * Motor commands are only sent when 'commands' is flushed.
+     *
+     * @param commands the buffer motor commands go through.
+     * @param config the ports, must outlive the intake.
+     * @param stall the jam detection thresholds.
+     */
+    explicit Intake(ls::MotorCommandBuffer& commands, const RobotConfig& config = robotConfig(), ls::StallConfig stall = {});
+
+    /**
+     * @brief Initializes the motors.
+     */
+    void initialize();
+
+    /**
+     * @brief Registers the motors with the state cache jams are detected from.
+     * Without it the intake still runs, it just never unjams.
+     *
+     * @param cache the cache, refreshed every tick by its owner.
+     */
+    void attach(ls::MotorStateCache& cache);
+
+    /**
+     * @brief Registers the motors with a motor monitor, and derates the output (unjamming included)
+     * by the hottest motor's power scale.
+     *
+     * @param monitor the monitor, must be started by its owner.
+     */
+    void attach(ls::MotorMonitor& monitor);
+
+    /**
+     * @brief Sets how a jam is cleared.
+     *
+     * @param volts the voltage to reverse at (0, 12].
+     * @param time how long to reverse, in ms.
+     */
+    void setUnjam(float volts, std::uint32_t time);
+
+    /**
+     * @brief Runs the intake, applied on the next update().
+     *
+     * @param volts the voltage [-12, 12], positive takes rings in.
+     */
+    void move(float volts);
+
+    /**
+     * @brief Stops the intake on the next update(), cancelling an unjam.
+     */
+    void stop();
+
+    /**
+     * @brief Checks for a jam and sets the motor command, call once per tick after the state cache refresh.
+     *
+     * @param dt time since the last update in seconds.
+     */
+    void update(float dt);
+
+    /**
+     * @brief Counts a ring that went through, ex. from the color sensor. Safe to call from any task.
+     */
+    void countRing();
+
+    /**
+     * @brief Gets what the intake is doing.
+     */
+    IntakeState getState() const;
+
+    /**
+     * @brief Gets the counters, from the task that calls update().
+     */
+    IntakeStats getStats() const;
+
+    /**
+     * @brief Gets the intake motors.
+     */
+    pros::MotorGroup& getMotors();
+};
+
+#endif // INTAKE_HS_H
@@ -0,0 +1,164 @@
+#ifndef ROBOTCONFIG_HS_H
+#define ROBOTCONFIG_HS_H
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include "LibStoga/config.h"
+#include "LibStoga/geometry.h"
+#include "LibStoga/ports.h"
+
+/**
+ * @brief Every measurement and port of the robot, read-only once loaded.
+ *
+ * The defaults are DEFAULT_CONFIG in settings.h and can be overridden by ROBOT_CONFIG_FILE on the SD card,
+ * so a new measurement does not need a rebuild. Floats come first, then ports and flags, so there is no padding between members.
+ */
+struct RobotConfig {
+    // Measurements, in inches:
+    float trackingDiameter; // tracking_diameter
+    float rightTrackingOffset; // right_tracking_offset, center of rotation to the right tracking wheel
+    float leftTrackingOffset; // left_tracking_offset
+    float centerTrackingOffset; // center_tracking_offset
+    float wheelDiameter; // wheel_diameter, of the driven wheels
+    float gearRatio; // gear_ratio, wheel turns per motor (cartridge output) turn
+    float wheelTrack; // wheel_track, between the left and right wheels
+    float conveyorTravel; // conveyor_travel, chain travel per intake motor (cartridge output) turn
+    float ejectDistance; // eject_distance, along the conveyor from the color sensor to the ejector
+    float armRestAngle; // arm_rest_angle, in degrees from horizontal (positive up) where the arm rests at boot
+
+    // Ports, negative if reversed:
+    ls::PortList leftPorts; // left_ports, 0 for unused entries
+    ls::PortList rightPorts; // right_ports
+    ls::PortList intakePorts; // intake_ports, the conveyor motors
+    ls::PortList armPorts; // arm_ports, the wall stake arm motors
+    std::int8_t rightTracking; // right_tracking, rotation sensor
+    std::int8_t leftTracking; // left_tracking
+    std::int8_t centerTracking; // center_tracking
+    std::int8_t colorSensor; // color_sensor, optical sensor on the conveyor
+    std::int8_t goalSensor; // goal_sensor, distance sensor in the mobile goal clamp
+    std::int8_t armSensor; // arm_sensor, rotation sensor on the arm pivot
+    std::int8_t linkRadio; // link_radio, the VEXlink radio to the alliance partner
+    char ejector; // ejector, three wire port of the ring ejector piston
+    char clamp; // clamp, three wire port of the mobile goal clamp piston
+
+    // Alliance link:
+    bool linkTransmitter; // link_transmitter, true on exactly one robot of the alliance, it also wins ties when yielding
+};
+
+/**
+ * @brief Every smart port in the config, motors first and then the sensors.
+ */
+constexpr std::array<std::int8_t, 4 * std::tuple_size_v<ls::PortList> + 7> smartPorts(const RobotConfig& config) {
+    std::array<std::int8_t, 4 * std::tuple_size_v<ls::PortList> + 7> ports{};
+    std::size_t count = 0;
+    for (std::int8_t port : config.leftPorts) ports[count++] = port;
+    for (std::int8_t port : config.rightPorts) ports[count++] = port;
+    for (std::int8_t port : config.intakePorts) ports[count++] = port;
+    for (std::int8_t port : config.armPorts) ports[count++] = port;
+    ports[count++] = config.rightTracking;
+    ports[count++] = config.leftTracking;
+    ports[count++] = config.centerTracking;
+    ports[count++] = config.colorSensor;
+    ports[count++] = config.goalSensor;
+    ports[count++] = config.armSensor;
+    ports[count++] = config.linkRadio;
+    return ports;
+}
+
+/**
+ * @brief Every three wire port in the config.
+ */
+constexpr std::array<char, 2> adiPorts(const RobotConfig& config) {
+    return {config.ejector, config.clamp};
+}
+
+/**
+ * @brief Checks a motor list: every port is in [1, 21] (either sign) and there is at least one motor.
+ */
+constexpr bool motorPortsInRange(const ls::PortList& ports) {
+    bool hasMotor = false;
+    for (std::int8_t port : ports) {
+        if (port != 0 && !ls::isSmartPort(port)) return false;
+        hasMotor |= port != 0;
+    }
+    return hasMotor;
+}
+
+/**
+ * @brief Checks that every port exists and each motor group has at least one motor.
+ */
+constexpr bool portsInRange(const RobotConfig& config) {
+    if (!motorPortsInRange(config.leftPorts) || !motorPortsInRange(config.rightPorts)
+        || !motorPortsInRange(config.intakePorts) || !motorPortsInRange(config.armPorts)) {
+        return false;
+    }
+    for (std::int8_t port : smartPorts(config)) {
+        if (port != 0 && !ls::isSmartPort(port)) return false;
+    }
+    for (char port : adiPorts(config)) {
+        if (!ls::isAdiPort(port)) return false;
+    }
+    return ls::isSmartPort(config.rightTracking) && ls::isSmartPort(config.leftTracking)
+        && ls::isSmartPort(config.centerTracking) && ls::isSmartPort(config.colorSensor)
+        && ls::isSmartPort(config.goalSensor) && ls::isSmartPort(config.armSensor) && ls::isSmartPort(config.linkRadio);
+}
+
+/**
+ * @brief Checks that no port is shared by two devices (motors and sensors are all smart ports).
+ */
+constexpr bool portsUnique(const RobotConfig& config) {
+    return ls::uniqueSmartPorts(smartPorts(config)) && ls::uniqueAdiPorts(adiPorts(config));
+}
+
+/**
+ * @brief Checks that the measurements are physically possible.
+ */
+constexpr bool measurementsValid(const RobotConfig& config) {
+    return config.trackingDiameter > 0 && config.wheelDiameter > 0 && config.gearRatio > 0 && config.wheelTrack > 0
+        && config.rightTrackingOffset >= 0 && config.leftTrackingOffset >= 0
+        && config.rightTrackingOffset + config.leftTrackingOffset > 0 // the heading comes from their difference
+        && config.conveyorTravel > 0 && config.ejectDistance >= 0
+        && config.armRestAngle >= -180 && config.armRestAngle <= 180;
+}
+
+/**
+ * @brief Checks a whole config, used on the file at boot and on the defaults at compile time.
+ *
+ * @param config the config to check.
+ * @return if the config is usable.
+ */
+constexpr bool validateConfig(const RobotConfig& config) {
+    return portsInRange(config) && portsUnique(config) && measurementsValid(config);
+}
+
+/**
+ * @brief Conversion factors that follow from a config, computed once instead of every tick.
+ */
+struct DriveGeometry {
+    float inchesPerRpm; // wheel in/s per motor rpm
+    float inchesPerDegree; // wheel travel per motor degree
+    float halfTrack; // center of the robot to the wheels, in inches
+    float trackingRadius; // in inches
+};
+
+/**
+ * @brief Computes the conversion factors of a config.
+ */
+constexpr DriveGeometry driveGeometry(const RobotConfig& config) {
+    return {
+        static_cast<float>(ls::PI * config.wheelDiameter * config.gearRatio / 60),
+        static_cast<float>(ls::PI * config.wheelDiameter * config.gearRatio / 360),
+        config.wheelTrack / 2,
+        config.trackingDiameter / 2
+    };
+}
+
+/**
+ * @brief Gets the robot config.
+ * ROBOT_CONFIG_FILE is read on the first call (while the globals in main.cpp are constructed, before initialize()),
+ * every later call returns the same struct. Falls back to DEFAULT_CONFIG (settings.h) if the file is missing or invalid.
+ */
+const RobotConfig& robotConfig();
+
+#endif // ROBOTCONFIG_HS_H
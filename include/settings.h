@@ -1,21 +1,62 @@
 #ifndef SETTINGS_HS_H
 #define SETTINGS_HS_H
 
-// Port deffinitions:
-#define LEFT_PORTS {1, 2, 3}
-#define RIGHT_PORTS {4, 5, 6}
+#include "robotconfig.h"
 
-// Odom definitions: (imu can be found out using static method)
-#define RIGHT_TRACKING 69
-#define LEFT_TRACKING 69
-#define CENTER_TRACKING 69
-#define TRACKING_DIAMETER 2.75
-#define PARALLEL_SENSOR_TRACK_WIDTH 7
-#define MIDDLE_ENCODER_DISTANCE 1
+// Compiled-in defaults, ROBOT_CONFIG_FILE overrides them at boot (see robotconfig.h).
+// Checked below at compile time, a bad port or measurement here fails the build.
+inline constexpr RobotConfig DEFAULT_CONFIG{
+    // Odom definitions: (imu can be found out using static method)
+    .trackingDiameter = 2.75,
+    .rightTrackingOffset = 7,
+    .leftTrackingOffset = 7,
+    .centerTrackingOffset = 1,
 
-// Drivetrain definitions:
-#define DRIVETRAIN_WHEEL_INCHES 3.25
-#define WHEEL_TRACK_INCHES 11.5 // This is the space between the right WHEELS and left WHEELS.
+    // Drivetrain definitions:
+    .wheelDiameter = 3.25,
+    .gearRatio = 1.0, // wheel turns per motor (cartridge output) turn
+    .wheelTrack = 11.5, // This is the space between the right WHEELS and left WHEELS.
 
+    // Conveyor definitions:
+    .conveyorTravel = 2.25, // 6 tooth sprocket, 0.375in chain pitch
+    .ejectDistance = 5,
 
-#endif // SETTINGS_HS_H
\ No newline at end of file
+    // Wall stake arm definitions:
+    .armRestAngle = -60,
+
+    // Port deffinitions: (negative if reversed)
+    .leftPorts = {1, 2, 3},
+    .rightPorts = {4, 5, 6},
+    .intakePorts = {10},
+    .armPorts = {13},
+    .rightTracking = -7,
+    .leftTracking = 8,
+    .centerTracking = 9,
+    .colorSensor = 11,
+    .goalSensor = 12,
+    .armSensor = 14,
+    .linkRadio = 15,
+    .ejector = 'A',
+    .clamp = 'B',
+
+    // Alliance link definitions:
+    .linkTransmitter = false, // set to true in robot.cfg on the partner robot
+};
+
+static_assert(portsInRange(DEFAULT_CONFIG), "a port in DEFAULT_CONFIG does not exist, or a motor group has no motors.");
+static_assert(portsUnique(DEFAULT_CONFIG), "two devices in DEFAULT_CONFIG share a port.");
+static_assert(measurementsValid(DEFAULT_CONFIG), "a measurement in DEFAULT_CONFIG is zero, negative or out of range.");
+
+// Alliance link: both robots use the same name, and send field coordinates from where odom starts.
+inline constexpr const char* ALLIANCE_LINK_ID = "stoga_alliance";
+inline constexpr double START_X = 72; // in inches from the left wall
+inline constexpr double START_Y = 72; // in inches from the bottom wall
+inline constexpr double START_HEADING = 0; // bearing the robot faces at the start, in degrees
+
+// Files on the SD card:
+inline constexpr const char* ROBOT_CONFIG_FILE = "/usd/robot.cfg"; // "key = value" lines, see robotconfig.h for the keys
+inline constexpr const char* FEEDFORWARD_FILE = "/usd/feedforward.txt"; // written by the characterize routine, loaded at boot
+inline constexpr const char* CHARACTERIZE_LOG_FILE = "/usd/characterize.csv";
+
+
+#endif // SETTINGS_HS_H
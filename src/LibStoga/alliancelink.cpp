@@ -0,0 +1,391 @@
+#include "alliancelink.h"
+#include <algorithm>
+#include <cmath>
+#include "geometry.h"
+
+namespace ls {
+    namespace {
+        constexpr std::uint8_t SYNC_0 = 0xA5;
+        constexpr std::uint8_t SYNC_1 = 0x5A;
+        constexpr float TIE_DISTANCE = 1; // in inches, closer than this to the meeting point counts as a tie
+
+        void put16(PacketFrame& frame, std::size_t offset, std::uint16_t value)
+        {
+            frame[offset] = static_cast<std::uint8_t>(value);
+            frame[offset + 1] = static_cast<std::uint8_t>(value >> 8);
+        }
+
+        std::uint16_t get16(const std::uint8_t* frame, std::size_t offset)
+        {
+            return static_cast<std::uint16_t>(frame[offset] | (frame[offset + 1] << 8));
+        }
+
+        // rounds to a fixed point int16, saturating instead of wrapping.
+        std::uint16_t fixed(float value, float scale)
+        {
+            const float scaled = std::round(value * scale);
+            return static_cast<std::uint16_t>(static_cast<std::int16_t>(std::clamp(scaled, -32768.0f, 32767.0f)));
+        }
+
+        float unfixed(std::uint16_t value, float scale)
+        {
+            return static_cast<std::int16_t>(value) / scale;
+        }
+
+        float wrapDegrees(float degrees)
+        {
+            const float wrapped = std::fmod(degrees, 360.0f);
+            return wrapped < 0 ? wrapped + 360 : wrapped;
+        }
+
+        // difference a - b in (-180, 180].
+        float degreesBetween(float a, float b)
+        {
+            const float d = wrapDegrees(a - b);
+            return d > 180 ? d - 360 : d;
+        }
+
+        // CRC-8, polynomial 0x07.
+        std::uint8_t crc8(const std::uint8_t* data, std::size_t size)
+        {
+            std::uint8_t crc = 0;
+            for (std::size_t i = 0; i < size; i++) {
+                crc ^= data[i];
+                for (int bit = 0; bit < 8; bit++) crc = crc & 0x80 ? static_cast<std::uint8_t>((crc << 1) ^ 0x07) : static_cast<std::uint8_t>(crc << 1);
+            }
+            return crc;
+        }
+
+        struct Vec {
+            float x;
+            float y;
+        };
+
+        // closest points between segments p1-q1 and p2-q2 (either may be a point), returns their distance.
+        float segmentDistance(Vec p1, Vec q1, Vec p2, Vec q2, Vec& c1, Vec& c2)
+        {
+            constexpr float EPSILON = 1e-6f;
+            const Vec d1{q1.x - p1.x, q1.y - p1.y};
+            const Vec d2{q2.x - p2.x, q2.y - p2.y};
+            const Vec r{p1.x - p2.x, p1.y - p2.y};
+            const float a = d1.x * d1.x + d1.y * d1.y;
+            const float e = d2.x * d2.x + d2.y * d2.y;
+            const float f = d2.x * r.x + d2.y * r.y;
+            float s = 0;
+            float t = 0;
+            if (a > EPSILON || e > EPSILON) {
+                if (a <= EPSILON) {
+                    t = std::clamp(f / e, 0.0f, 1.0f);
+                } else {
+                    const float c = d1.x * r.x + d1.y * r.y;
+                    if (e <= EPSILON) {
+                        s = std::clamp(-c / a, 0.0f, 1.0f);
+                    } else {
+                        const float b = d1.x * d2.x + d1.y * d2.y;
+                        const float denom = a * e - b * b; // 0 when parallel
+                        s = denom > EPSILON ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0;
+                        t = (b * s + f) / e;
+                        if (t < 0) {
+                            t = 0;
+                            s = std::clamp(-c / a, 0.0f, 1.0f);
+                        } else if (t > 1) {
+                            t = 1;
+                            s = std::clamp((b - c) / a, 0.0f, 1.0f);
+                        }
+                    }
+                }
+            }
+            c1 = {p1.x + d1.x * s, p1.y + d1.y * s};
+            c2 = {p2.x + d2.x * t, p2.y + d2.y * t};
+            return std::hypot(c1.x - c2.x, c1.y - c2.y);
+        }
+    }
+
+    void encodePacket(const AlliancePacket& packet, PacketFrame& frame)
+    {
+        frame[0] = SYNC_0;
+        frame[1] = SYNC_1;
+        put16(frame, 2, packet.sequence);
+        put16(frame, 4, fixed(packet.x, 100));
+        put16(frame, 6, fixed(packet.y, 100));
+        put16(frame, 8, static_cast<std::uint16_t>(std::lround(wrapDegrees(packet.heading) * 100) % 36000));
+        put16(frame, 10, fixed(packet.vx, 100));
+        put16(frame, 12, fixed(packet.vy, 100));
+        put16(frame, 14, fixed(packet.omega, 10));
+        put16(frame, 16, fixed(packet.targetX, 100));
+        put16(frame, 18, fixed(packet.targetY, 100));
+        put16(frame, 20, packet.flags);
+        frame[22] = crc8(frame.data() + 2, 20);
+    }
+
+    bool decodePacket(const std::uint8_t* frame, AlliancePacket& packet)
+    {
+        if (frame[0] != SYNC_0 || frame[1] != SYNC_1 || frame[22] != crc8(frame + 2, 20)) return false;
+        packet.sequence = get16(frame, 2);
+        packet.x = unfixed(get16(frame, 4), 100);
+        packet.y = unfixed(get16(frame, 6), 100);
+        packet.heading = get16(frame, 8) / 100.0f;
+        packet.vx = unfixed(get16(frame, 10), 100);
+        packet.vy = unfixed(get16(frame, 12), 100);
+        packet.omega = unfixed(get16(frame, 14), 10);
+        packet.targetX = unfixed(get16(frame, 16), 100);
+        packet.targetY = unfixed(get16(frame, 18), 100);
+        packet.flags = get16(frame, 20);
+        return true;
+    }
+
+    void LoopbackTransport::connect(LoopbackTransport& a, LoopbackTransport& b)
+    {
+        a.peer = &b;
+        b.peer = &a;
+    }
+
+    void LoopbackTransport::setLoss(std::uint32_t everyNth)
+    {
+        loss = everyNth;
+    }
+
+    bool LoopbackTransport::connected()
+    {
+        return peer != nullptr;
+    }
+
+    std::size_t LoopbackTransport::send(const std::uint8_t* data, std::size_t count)
+    {
+        if (peer == nullptr || peer->size + count > CAPACITY) return 0;
+        sends++;
+        if (loss != 0 && sends % loss == 0) return count; // lost on the way, the sender can't tell
+        for (std::size_t i = 0; i < count; i++) {
+            peer->buffer[(peer->head + peer->size + i) % CAPACITY] = data[i];
+        }
+        peer->size += count;
+        return count;
+    }
+
+    std::size_t LoopbackTransport::available()
+    {
+        return size;
+    }
+
+    std::size_t LoopbackTransport::receive(std::uint8_t* dest, std::size_t count)
+    {
+        const std::size_t n = std::min(count, size);
+        for (std::size_t i = 0; i < n; i++) dest[i] = buffer[(head + i) % CAPACITY];
+        head = (head + n) % CAPACITY;
+        size -= n;
+        return n;
+    }
+
+    AllianceLink::AllianceLink(LinkTransport& transport, AllianceLinkSettings settings)
+        : transport(transport), settings(settings) {}
+
+    void AllianceLink::setOrigin(double x, double y, double heading)
+    {
+        originX = x;
+        originY = y;
+        originHeading = heading;
+        originSin = std::sin(heading * DEG_TO_RAD);
+        originCos = std::cos(heading * DEG_TO_RAD);
+    }
+
+    void AllianceLink::setPose(double x, double y, double heading)
+    {
+        // odom is a bearing frame turned by the start heading, so rotate it clockwise onto the field.
+        local.x = static_cast<float>(originX + x * originCos + y * originSin);
+        local.y = static_cast<float>(originY - x * originSin + y * originCos);
+        local.heading = wrapDegrees(static_cast<float>(heading + originHeading));
+        hasPose = true;
+    }
+
+    void AllianceLink::setTarget(double x, double y)
+    {
+        local.targetX = static_cast<float>(originX + x * originCos + y * originSin);
+        local.targetY = static_cast<float>(originY - x * originSin + y * originCos);
+        localFlags |= 1 << static_cast<std::uint8_t>(PartnerFlag::HasTarget);
+    }
+
+    void AllianceLink::clearTarget()
+    {
+        localFlags &= ~(1 << static_cast<std::uint8_t>(PartnerFlag::HasTarget));
+    }
+
+    void AllianceLink::setFlag(PartnerFlag flag, bool on)
+    {
+        if (flag == PartnerFlag::Moving || flag == PartnerFlag::Yielding) return;
+        const std::uint16_t bit = 1 << static_cast<std::uint8_t>(flag);
+        localFlags = on ? localFlags | bit : localFlags & ~bit;
+    }
+
+    void AllianceLink::update(std::uint32_t now)
+    {
+        receive(now);
+        updateYield(now);
+        if (!hasPose) return;
+        if (!sentOnce || static_cast<std::int32_t>(now - nextSend) >= 0) {
+            send(now);
+            // on a fixed schedule, unless the ticks fell a whole period behind.
+            nextSend = sentOnce && static_cast<std::int32_t>(now - (nextSend + settings.period)) < 0 ? nextSend + settings.period : now + settings.period;
+            sentOnce = true;
+        }
+    }
+
+    void AllianceLink::receive(std::uint32_t now)
+    {
+        while (true) {
+            const std::size_t room = rx.size() - rxSize;
+            const std::size_t got = room > 0 && transport.available() > 0 ? transport.receive(rx.data() + rxSize, room) : 0;
+            rxSize += got;
+
+            std::size_t start = 0;
+            while (rxSize - start >= PACKET_SIZE) {
+                AlliancePacket packet;
+                if (decodePacket(rx.data() + start, packet)) {
+                    accept(packet, now);
+                    start += PACKET_SIZE;
+                } else {
+                    stats.corrupt++;
+                    start++; // resync on the next byte
+                }
+            }
+            std::copy(rx.begin() + start, rx.begin() + rxSize, rx.begin());
+            rxSize -= start;
+            if (got == 0) break;
+        }
+    }
+
+    void AllianceLink::accept(const AlliancePacket& packet, std::uint32_t now)
+    {
+        const bool fresh = isPartnerFresh(now);
+        if (fresh) {
+            const std::int16_t ahead = static_cast<std::int16_t>(packet.sequence - partner.sequence);
+            if (ahead <= 0) {
+                stats.stale++;
+                return;
+            }
+            stats.lost += ahead - 1;
+        }
+        stats.received++;
+
+        // where the packet says the partner is now, not when it was sent.
+        const float lead = settings.latency / 1000.0f;
+        const float measuredX = packet.x + packet.vx * lead;
+        const float measuredY = packet.y + packet.vy * lead;
+        const float measuredHeading = packet.heading + packet.omega * lead;
+        if (!fresh) {
+            // first packet, or the partner was lost (it may have rebooted and restarted its sequence).
+            estimateX = measuredX;
+            estimateY = measuredY;
+            estimateHeading = wrapDegrees(measuredHeading);
+        } else {
+            const float dt = (now - partnerTime) / 1000.0f;
+            const float predictedX = estimateX + partner.vx * dt;
+            const float predictedY = estimateY + partner.vy * dt;
+            const float predictedHeading = estimateHeading + partner.omega * dt;
+            estimateX = predictedX + settings.positionGain * (measuredX - predictedX);
+            estimateY = predictedY + settings.positionGain * (measuredY - predictedY);
+            estimateHeading = wrapDegrees(predictedHeading + settings.positionGain * degreesBetween(measuredHeading, predictedHeading));
+        }
+        partner = packet;
+        partnerTime = now;
+        hasPartner = true;
+    }
+
+    void AllianceLink::updateYield(std::uint32_t now)
+    {
+        if (!hasPose || !isPartnerFresh(now)) {
+            yielding = false;
+            return;
+        }
+        const PartnerEstimate other = getPartner(now);
+        const bool hasTarget = hasFlag(localFlags, PartnerFlag::HasTarget);
+        const Vec ownStart{local.x, local.y};
+        const Vec ownEnd = hasTarget ? Vec{local.targetX, local.targetY} : ownStart;
+        const Vec otherStart{other.x, other.y};
+        const Vec otherEnd = other.hasTarget ? Vec{other.targetX, other.targetY} : otherStart;
+
+        Vec ownMeet;
+        Vec otherMeet;
+        const float distance = segmentDistance(ownStart, ownEnd, otherStart, otherEnd, ownMeet, otherMeet);
+        // a little wider to stop yielding than to start, so it does not flicker on the edge.
+        if (distance >= settings.clearance * (yielding ? 1.2f : 1.0f)) {
+            yielding = false;
+            return;
+        }
+        if (hasFlag(other.flags, PartnerFlag::Yielding)) {
+            // the partner waits for us, unless both started yielding at once: then the leader goes.
+            yielding = yielding && !settings.leader;
+            return;
+        }
+        const float ownDistance = std::hypot(ownMeet.x - ownStart.x, ownMeet.y - ownStart.y);
+        const float otherDistance = std::hypot(otherMeet.x - otherStart.x, otherMeet.y - otherStart.y);
+        if (std::fabs(ownDistance - otherDistance) < TIE_DISTANCE) {
+            yielding = !settings.leader;
+        } else {
+            yielding = ownDistance > otherDistance;
+        }
+    }
+
+    void AllianceLink::send(std::uint32_t now)
+    {
+        if (sentOnce && now != lastSend) {
+            const float dt = (now - lastSend) / 1000.0f;
+            local.vx = (local.x - lastSentX) / dt;
+            local.vy = (local.y - lastSentY) / dt;
+            local.omega = degreesBetween(local.heading, lastSentHeading) / dt;
+        }
+        lastSentX = local.x;
+        lastSentY = local.y;
+        lastSentHeading = local.heading;
+        lastSend = now;
+
+        local.flags = localFlags;
+        if (std::hypot(local.vx, local.vy) > settings.movingSpeed) local.flags |= 1 << static_cast<std::uint8_t>(PartnerFlag::Moving);
+        if (yielding) local.flags |= 1 << static_cast<std::uint8_t>(PartnerFlag::Yielding);
+        local.sequence++;
+
+        PacketFrame frame;
+        encodePacket(local, frame);
+        if (transport.send(frame.data(), frame.size()) == frame.size()) stats.sent++;
+    }
+
+    PartnerEstimate AllianceLink::getPartner(std::uint32_t now) const
+    {
+        PartnerEstimate estimate;
+        if (!hasPartner) return estimate;
+        estimate.age = now - partnerTime;
+        if (!isPartnerFresh(now)) return estimate;
+
+        const float dt = estimate.age / 1000.0f;
+        estimate.valid = true;
+        estimate.x = estimateX + partner.vx * dt;
+        estimate.y = estimateY + partner.vy * dt;
+        estimate.heading = wrapDegrees(estimateHeading + partner.omega * dt);
+        estimate.vx = partner.vx;
+        estimate.vy = partner.vy;
+        estimate.hasTarget = hasFlag(partner.flags, PartnerFlag::HasTarget);
+        estimate.targetX = partner.targetX;
+        estimate.targetY = partner.targetY;
+        estimate.flags = partner.flags;
+        return estimate;
+    }
+
+    bool AllianceLink::isPartnerFresh(std::uint32_t now) const
+    {
+        return hasPartner && now - partnerTime <= settings.staleTimeout;
+    }
+
+    bool AllianceLink::shouldYield() const
+    {
+        return yielding;
+    }
+
+    AlliancePacket AllianceLink::getLocal() const
+    {
+        return local;
+    }
+
+    LinkStats AllianceLink::getStats() const
+    {
+        return stats;
+    }
+}
@@ -0,0 +1,104 @@
+#include "auton.h"
+#include <stdexcept>
+
+namespace ls {
+    // Layout of the selector on the 480x240 brain screen.
+    constexpr std::int16_t HEADER_HEIGHT = 40;
+    constexpr std::int16_t COLUMNS = 3;
+    constexpr std::int16_t BUTTON_WIDTH = 480 / COLUMNS;
+    constexpr std::int16_t BUTTON_HEIGHT = (240 - HEADER_HEIGHT) / ((MAX_AUTONS + COLUMNS - 1) / COLUMNS);
+
+    static_assert(MAX_AUTONS <= 32, "prewarmed flags are stored in a 32 bit mask.");
+
+    void AutonSelector::select(std::size_t index)
+    {
+        if (index >= count) {
+            throw std::out_of_range("auton index is not in the table.");
+        }
+        selected = index;
+        const AutonRoutine &routine = table[index];
+        if (routine.prewarm != nullptr && !(prewarmed & (1u << index))) {
+            routine.prewarm();
+            prewarmed |= 1u << index;
+        }
+        prepared = routine.routine();
+    }
+
+    void AutonSelector::runSelector()
+    {
+        if (prepared.done()) select(selected);
+        draw();
+
+        bool wasPressed = false;
+        while (true) {
+            const pros::screen_touch_status_s_t touch = pros::screen::touch_status();
+            const bool pressed = touch.touch_status == pros::E_TOUCH_PRESSED || touch.touch_status == pros::E_TOUCH_HELD;
+            if (pressed && !wasPressed) {
+                const std::size_t index = buttonAt(touch.x, touch.y);
+                if (index < count && index != selected) {
+                    select(index);
+                    draw();
+                }
+            }
+            wasPressed = pressed;
+            pros::delay(20);
+        }
+    }
+
+    const AutonRoutine &AutonSelector::getSelected() const
+    {
+        return table[selected];
+    }
+
+    std::size_t AutonSelector::getSelectedIndex() const
+    {
+        return selected;
+    }
+
+    Command AutonSelector::take()
+    {
+        if (prepared.done()) select(selected);
+        return std::move(prepared);
+    }
+
+    void AutonSelector::draw() const
+    {
+        pros::screen::set_eraser(pros::Color::black);
+        pros::screen::erase();
+
+        pros::screen::set_pen(pros::Color::white);
+        pros::screen::print(pros::E_TEXT_MEDIUM, 8, 12, "Auton: %s", table[selected].name);
+
+        for (std::size_t i = 0; i < count; i++) {
+            const std::int16_t x0 = (i % COLUMNS) * BUTTON_WIDTH;
+            const std::int16_t y0 = HEADER_HEIGHT + (i / COLUMNS) * BUTTON_HEIGHT;
+            const std::int16_t x1 = x0 + BUTTON_WIDTH - 4;
+            const std::int16_t y1 = y0 + BUTTON_HEIGHT - 4;
+
+            switch (table[i].color) {
+                case AllianceColor::Red: pros::screen::set_pen(pros::Color::red); break;
+                case AllianceColor::Blue: pros::screen::set_pen(pros::Color::blue); break;
+                default: pros::screen::set_pen(pros::Color::dark_gray); break;
+            }
+            pros::screen::fill_rect(x0, y0, x1, y1);
+
+            if (i == selected) {
+                pros::screen::set_pen(pros::Color::white);
+                pros::screen::draw_rect(x0, y0, x1, y1);
+                pros::screen::draw_rect(x0 + 1, y0 + 1, x1 - 1, y1 - 1);
+            }
+            pros::screen::set_pen(pros::Color::white);
+            pros::screen::print(pros::E_TEXT_SMALL, x0 + 6, y0 + 6, "%s", table[i].name);
+        }
+    }
+
+    std::size_t AutonSelector::buttonAt(std::int16_t x, std::int16_t y) const
+    {
+        if (x < 0 || y < HEADER_HEIGHT) return count;
+        const std::size_t column = x / BUTTON_WIDTH;
+        const std::size_t row = (y - HEADER_HEIGHT) / BUTTON_HEIGHT;
+        if (column >= static_cast<std::size_t>(COLUMNS)) return count;
+        const std::size_t index = row * COLUMNS + column;
+        return index < count ? index : count;
+    }
+};
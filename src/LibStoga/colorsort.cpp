@@ -0,0 +1,240 @@
+#include "colorsort.h"
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace ls {
+    namespace {
+        // distance between two hues around the circle, in [0, 180].
+        double hueDistance(double a, double b)
+        {
+            const double d = std::fmod(std::fabs(a - b), 360.0);
+            return d > 180 ? 360 - d : d;
+        }
+    }
+
+    RingClassifier::RingClassifier(const ColorSortSettings& settings) : settings(settings) {}
+
+    RingColor RingClassifier::classify(double hue, float HueBand::*width) const
+    {
+        if (hueDistance(hue, settings.red.center) <= settings.red.*width) return RingColor::Red;
+        if (hueDistance(hue, settings.blue.center) <= settings.blue.*width) return RingColor::Blue;
+        return RingColor::None;
+    }
+
+    RingColor RingClassifier::update(double hue, std::int32_t proximity, std::uint64_t time)
+    {
+        if (current != RingColor::None) {
+            // the ring is kept until it clearly leaves: farther than the exit proximity, or outside the wider exit band.
+            const HueBand& band = current == RingColor::Red ? settings.red : settings.blue;
+            if (proximity < settings.proximityExit || hueDistance(hue, band.center) > band.exit) {
+                current = RingColor::None;
+                streak = 0;
+            }
+            return RingColor::None;
+        }
+
+        const RingColor color = proximity >= settings.proximityEnter ? classify(hue, &HueBand::enter) : RingColor::None;
+        if (color == RingColor::None) {
+            streak = 0;
+            return RingColor::None;
+        }
+        if (streak == 0 || color != candidate) {
+            candidate = color;
+            streak = 0;
+            since = time;
+        }
+        if (++streak < settings.confirmSamples) return RingColor::None;
+        current = color;
+        return color;
+    }
+
+    RingColor RingClassifier::getCurrent() const
+    {
+        return current;
+    }
+
+    std::uint64_t RingClassifier::getSince() const
+    {
+        return since;
+    }
+
+    void RingClassifier::reset()
+    {
+        current = RingColor::None;
+        streak = 0;
+    }
+
+    ColorSorter::ColorSorter(std::uint8_t opticalPort, pros::v5::AbstractMotor& conveyor, float inchesPerTurn, float ejectDistance, ColorSortSettings settings)
+        : optical(opticalPort), conveyor(conveyor), inchesPerRpm(inchesPerTurn / 60), ejectDistance(ejectDistance),
+          settings(settings), classifier(this->settings)
+    {
+        if (inchesPerTurn <= 0) {
+            throw std::invalid_argument("conveyor travel per turn must be positive.");
+        }
+        if (ejectDistance < 0) {
+            throw std::invalid_argument("eject distance can't be negative.");
+        }
+    }
+
+    ColorSorter::~ColorSorter()
+    {
+        stop();
+    }
+
+    void ColorSorter::onEject(Action extendAction, Action retractAction)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        extend = std::move(extendAction);
+        retract = std::move(retractAction);
+    }
+
+    void ColorSorter::onRing(std::function<void(RingColor color)> callback)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        ringCallback = std::move(callback);
+    }
+
+    void ColorSorter::setEjectColor(RingColor color)
+    {
+        ejectColor = color;
+    }
+
+    RingColor ColorSorter::getEjectColor() const
+    {
+        return ejectColor;
+    }
+
+    void ColorSorter::start()
+    {
+        if (running) return;
+        optical.set_led_pwm(100); // lights the ring, so the hue does not depend on the field lighting
+        optical.disable_gesture(); // gesture detection delays the color readings
+        classifier.reset();
+        pendingCount = 0;
+        running = true;
+        // above the control loop, so a due eject is never waiting behind it.
+        task = std::make_unique<pros::Task>([this]() { loop(); }, TASK_PRIORITY_DEFAULT + 2, TASK_STACK_DEPTH_DEFAULT, "color sort");
+    }
+
+    void ColorSorter::stop()
+    {
+        if (!running) return;
+        running = false;
+        task->join();
+        task.reset();
+        if (extended && retract) retract();
+        extended = false;
+        pendingCount = 0;
+    }
+
+    void ColorSorter::loop()
+    {
+        std::uint64_t nextSample = pros::micros();
+        while (running) {
+            std::uint64_t now = pros::micros();
+            if (now >= nextSample) {
+                sample(now);
+                nextSample += settings.samplePeriod * 1000;
+                if (nextSample <= now) nextSample = now + settings.samplePeriod * 1000; // fell behind, don't burst
+            }
+            act(pros::micros());
+
+            now = pros::micros();
+            std::uint64_t wake = nextWake(now);
+            if (nextSample < wake) wake = nextSample;
+            // the RTOS sleeps in whole ticks (1ms), rounded up so an action is at most one tick late, never early.
+            pros::delay(wake > now ? static_cast<std::uint32_t>((wake - now + 999) / 1000) : 1);
+        }
+    }
+
+    void ColorSorter::sample(std::uint64_t now)
+    {
+        const double hue = optical.get_hue();
+        const std::int32_t proximity = optical.get_proximity();
+        if (!std::isfinite(hue) || proximity == PROS_ERR) return; // unplugged
+
+        const RingColor color = classifier.update(hue, proximity, now);
+        if (color == RingColor::None) return;
+        counts[static_cast<std::uint8_t>(color)]++;
+        schedule(color, classifier.getSince(), now);
+        if (ringCallback) ringCallback(color);
+    }
+
+    void ColorSorter::schedule(RingColor color, std::uint64_t detectedAt, std::uint64_t now)
+    {
+        RingRecord record{color, detectedAt, 0, 0};
+        if (color == ejectColor) {
+            // the only motor read per ring, its cached velocity is fresh to ~10ms.
+            record.speed = static_cast<float>(conveyor.get_actual_velocity()) * inchesPerRpm;
+            if (!std::isfinite(record.speed) || record.speed < settings.minSpeed || pendingCount == MAX_PENDING) {
+                missed++;
+            } else {
+                const std::uint64_t travel = static_cast<std::uint64_t>(ejectDistance / record.speed * 1e6);
+                const std::uint64_t lead = settings.actuationDelay * 1000;
+                std::uint64_t at = detectedAt + travel > lead ? detectedAt + travel - lead : 0;
+                if (at < now) at = now; // the ejector is closer than its own delay, fire right away
+                record.ejectAt = at;
+
+                std::size_t i = pendingCount++;
+                for (; i > 0 && pending[i - 1] > at; i--) pending[i] = pending[i - 1];
+                pending[i] = at;
+            }
+        }
+        std::lock_guard<pros::Mutex> lock(mutex);
+        last = record;
+    }
+
+    void ColorSorter::act(std::uint64_t now)
+    {
+        if (extended && now >= retractAt) {
+            if (retract) retract();
+            extended = false;
+        }
+        while (pendingCount > 0 && pending[0] <= now) {
+            const std::uint32_t lateness = static_cast<std::uint32_t>(now - pending[0]);
+            if (lateness > maxLateness) maxLateness = lateness;
+            if (!extended && extend) extend();
+            extended = true;
+            // a second ring right behind the first keeps the ejector out instead of retracting under it.
+            retractAt = now + settings.ejectTime * 1000;
+            ejected++;
+            for (std::size_t i = 1; i < pendingCount; i++) pending[i - 1] = pending[i];
+            pendingCount--;
+        }
+    }
+
+    std::uint64_t ColorSorter::nextWake(std::uint64_t now) const
+    {
+        std::uint64_t wake = UINT64_MAX;
+        if (pendingCount > 0) wake = pending[0];
+        if (extended && retractAt < wake) wake = retractAt;
+        return wake < now ? now : wake;
+    }
+
+    RingRecord ColorSorter::getLastRing()
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        return last;
+    }
+
+    std::uint32_t ColorSorter::getCount(RingColor color) const
+    {
+        return counts[static_cast<std::uint8_t>(color)];
+    }
+
+    std::uint32_t ColorSorter::getEjected() const
+    {
+        return ejected;
+    }
+
+    std::uint32_t ColorSorter::getMissed() const
+    {
+        return missed;
+    }
+
+    std::uint32_t ColorSorter::getMaxLateness() const
+    {
+        return maxLateness;
+    }
+}
@@ -0,0 +1,414 @@
+#include "command.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Code for the FrameArena allocator.
+ *
+ */
+#ifndef LS_FRAME_ARENA_SIZE
+#define LS_FRAME_ARENA_SIZE 32768
+#endif
+
+namespace ls {
+    namespace {
+        constexpr std::size_t MIN_BLOCK = 64;
+        constexpr std::size_t SIZE_CLASSES = 6; // 64, 128, ... 2048 bytes
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        alignas(std::max_align_t) unsigned char arena[LS_FRAME_ARENA_SIZE];
+        std::size_t arenaUsed = 0;
+        std::size_t heapFallbacks = 0;
+        FreeBlock *freeLists[SIZE_CLASSES] = {};
+
+        /**
+         * @brief Returns the size class of a frame, or SIZE_CLASSES if it is too big for the arena.
+         */
+        std::size_t sizeClass(std::size_t size)
+        {
+            std::size_t cls = 0;
+            std::size_t block = MIN_BLOCK;
+            while (block < size && cls < SIZE_CLASSES) {
+                block <<= 1;
+                cls++;
+            }
+            return cls;
+        }
+    }
+
+    void *FrameArena::allocate(std::size_t size)
+    {
+        const std::size_t cls = sizeClass(size);
+        if (cls < SIZE_CLASSES) {
+            if (freeLists[cls] != nullptr) {
+                FreeBlock *block = freeLists[cls];
+                freeLists[cls] = block->next;
+                return block;
+            }
+            const std::size_t block = MIN_BLOCK << cls;
+            if (arenaUsed + block <= LS_FRAME_ARENA_SIZE) {
+                void *ptr = arena + arenaUsed;
+                arenaUsed += block;
+                return ptr;
+            }
+        }
+        heapFallbacks++;
+        return ::operator new(size);
+    }
+
+    void FrameArena::deallocate(void *ptr, std::size_t size)
+    {
+        unsigned char *bytes = static_cast<unsigned char *>(ptr);
+        if (bytes < arena || bytes >= arena + LS_FRAME_ARENA_SIZE) {
+            ::operator delete(ptr);
+            return;
+        }
+        const std::size_t cls = sizeClass(size);
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = freeLists[cls];
+        freeLists[cls] = block;
+    }
+
+    std::size_t FrameArena::getUsed()
+    {
+        return arenaUsed;
+    }
+
+    std::size_t FrameArena::getHeapFallbacks()
+    {
+        return heapFallbacks;
+    }
+};
+
+/**
+ * @brief Code for the Command coroutine type.
+ *
+ */
+namespace ls {
+    Command Command::promise_type::get_return_object()
+    {
+        return Command(handle_type::from_promise(*this));
+    }
+
+    Command::promise_type::~promise_type()
+    {
+        if (waiting && scheduler != nullptr) {
+            scheduler->forget(handle_type::from_promise(*this));
+        }
+    }
+
+    Command::Command(Command &&other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) {}
+
+    Command &Command::operator=(Command &&other) noexcept
+    {
+        if (this != &other) {
+            cancel();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Command::~Command()
+    {
+        cancel();
+    }
+
+    bool Command::done() const
+    {
+        return !handle || handle.done();
+    }
+
+    void Command::cancel()
+    {
+        if (handle) {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+
+    void Command::start(Scheduler &scheduler)
+    {
+        if (done()) return;
+        handle.promise().scheduler = &scheduler;
+        handle.resume();
+    }
+
+    void Command::rethrow() const
+    {
+        if (handle && handle.promise().exception) {
+            std::rethrow_exception(handle.promise().exception);
+        }
+    }
+};
+
+/**
+ * @brief Code for the Scheduler class.
+ *
+ */
+namespace ls {
+    Scheduler::Scheduler(std::uint32_t period): period(period)
+    {
+        // reserved up front so a running routine never has to grow these.
+        waiters.reserve(32);
+        roots.reserve(8);
+    }
+
+    void Scheduler::spawn(Command &&command)
+    {
+        current_time = pros::millis();
+        roots.push_back(std::move(command));
+        roots.back().start(*this);
+    }
+
+    void Scheduler::addTickHook(std::function<void()> hook)
+    {
+        hooks.push_back(std::move(hook));
+    }
+
+    void Scheduler::addEndHook(std::function<void()> hook)
+    {
+        end_hooks.push_back(std::move(hook));
+    }
+
+    void Scheduler::tick()
+    {
+        current_time = pros::millis();
+        tick_count++;
+        for (auto &hook : hooks) hook();
+
+        // resuming a command can add new waiters (growing the vector) or destroy others (nulling them),
+        // so walk by index and copy each entry out before resuming it.
+        for (std::size_t i = 0; i < waiters.size(); i++) {
+            const Waiter w = waiters[i];
+            if (!w.handle || w.tick == tick_count) continue;
+
+            const bool timed_out = !w.forever && static_cast<std::int32_t>(current_time - w.wake) >= 0;
+            if (timed_out || (w.condition != nullptr && w.condition(w.context))) {
+                waiters[i].handle = nullptr;
+                w.handle.promise().waiting = false;
+                w.handle.resume();
+            }
+        }
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(), [](const Waiter &w) { return !w.handle; }), waiters.end());
+
+        // finished commands are dropped before anything they threw is passed on.
+        std::exception_ptr failure = nullptr;
+        for (auto &root : roots) {
+            if (!root.done()) continue;
+            try {
+                root.rethrow();
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+            }
+        }
+        roots.erase(std::remove_if(roots.begin(), roots.end(), [](const Command &c) { return c.done(); }), roots.end());
+
+        for (auto &hook : end_hooks) hook();
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    void Scheduler::run()
+    {
+        std::uint32_t now = pros::millis();
+        while (!isIdle()) {
+            tick();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    void Scheduler::run(Command &&command)
+    {
+        spawn(std::move(command));
+        run();
+    }
+
+    void Scheduler::clear()
+    {
+        roots.clear();
+        waiters.clear();
+    }
+
+    bool Scheduler::isIdle() const
+    {
+        return roots.empty();
+    }
+
+    std::uint32_t Scheduler::now() const
+    {
+        return current_time;
+    }
+
+    std::uint32_t Scheduler::getPeriod() const
+    {
+        return period;
+    }
+
+    void Scheduler::await(Command::handle_type h, std::uint32_t timeout, bool (*condition)(const void *), const void *context)
+    {
+        h.promise().scheduler = this;
+        h.promise().waiting = true;
+        // a condition with no timeout waits forever.
+        const bool forever = timeout == 0 && condition != nullptr;
+        waiters.push_back(Waiter{h, current_time + timeout, forever, condition, context, tick_count});
+    }
+
+    void Scheduler::forget(Command::handle_type h)
+    {
+        for (auto &w : waiters) {
+            if (w.handle == h) w.handle = nullptr;
+        }
+    }
+};
+
+/**
+ * @brief Code for the awaitable primitives and combinators.
+ *
+ */
+namespace ls {
+    void WaitAwaiter::await_suspend(Command::handle_type h)
+    {
+        Scheduler *scheduler = h.promise().scheduler;
+        if (scheduler == nullptr) {
+            throw std::logic_error("commands must be run through a Scheduler before they can wait.");
+        }
+        if (!condition) {
+            scheduler->await(h, duration);
+            return;
+        }
+        scheduler->await(h, duration, [](const void *context) {
+            return (*static_cast<const std::function<bool()> *>(context))();
+        }, &condition);
+    }
+
+    WaitAwaiter nextTick()
+    {
+        return WaitAwaiter{0, nullptr};
+    }
+
+    WaitAwaiter wait(std::uint32_t ms)
+    {
+        return WaitAwaiter{ms, nullptr};
+    }
+
+    WaitAwaiter until(std::function<bool()> condition, std::uint32_t timeout)
+    {
+        return WaitAwaiter{timeout, std::move(condition)};
+    }
+
+    /**
+     * @brief Awaitable that starts every child on the parent's scheduler and waits on them.
+     */
+    struct JoinAwaiter {
+        Command* children;
+        std::size_t count;
+        detail::JoinMode mode;
+
+        static bool finished(const void *context)
+        {
+            const JoinAwaiter *self = static_cast<const JoinAwaiter *>(context);
+            Command *end = self->children + self->count;
+            auto done = [](const Command &c) { return c.done(); };
+            if (self->mode == detail::JoinMode::All) return std::all_of(self->children, end, done);
+            return self->count == 0 || std::any_of(self->children, end, done);
+        }
+
+        bool await_ready() const noexcept { return finished(this); }
+        bool await_suspend(Command::handle_type h)
+        {
+            Scheduler *scheduler = h.promise().scheduler;
+            for (std::size_t i = 0; i < count; i++) children[i].start(*scheduler);
+            if (finished(this)) return false; // everything finished without suspending.
+            scheduler->await(h, 0, &JoinAwaiter::finished, this);
+            return true;
+        }
+        void await_resume() const {}
+    };
+
+    Command detail::join(Command *commands, std::size_t count, JoinMode mode)
+    {
+        JoinAwaiter awaiter{commands, count, mode};
+        co_await awaiter;
+        for (std::size_t i = 0; i < count; i++) {
+            if (commands[i].done()) commands[i].rethrow();
+        }
+        for (std::size_t i = 0; i < count; i++) commands[i].cancel();
+    }
+
+    Command parallel(std::vector<Command> commands)
+    {
+        co_await detail::join(commands.data(), commands.size(), detail::JoinMode::All);
+    }
+
+    Command race(std::vector<Command> commands)
+    {
+        co_await detail::join(commands.data(), commands.size(), detail::JoinMode::Any);
+    }
+
+    Command sequence(std::vector<Command> commands)
+    {
+        for (auto &c : commands) co_await c;
+    }
+};
+
+/**
+ * @brief Code for the drivetrain primitives.
+ *
+ */
+namespace ls {
+    /**
+     * @brief Stops the drivetrain when a motion ends, including when it is cancelled mid-way.
+     */
+    struct OutputGuard {
+        std::function<void(double, double)>& output;
+        ~OutputGuard() { output(0, 0); }
+    };
+
+    Command drive(MotionConfig &config, double inches, std::uint32_t timeout)
+    {
+        OutputGuard guard{config.output};
+        config.linear->reset();
+        config.angular->reset();
+
+        const Position start = config.odom->getPosition();
+        double headingSin, headingCos;
+        Numeric<double>::sincos(start.theta.convertToRadians(), headingSin, headingCos);
+        const std::uint32_t startTime = pros::millis();
+
+        while (pros::millis() - startTime < timeout) {
+            Position current = config.odom->getPosition();
+            // project the displacement onto the starting heading (bearing, so x uses sin and y uses cos).
+            const double traveled = (current.X - start.X) * headingSin + (current.Y - start.Y) * headingCos;
+            const double error = inches - traveled;
+            Angle target = start.theta;
+            const double headingError = target.minimumAngleDifference(current.theta).getAngle();
+            if (fabs(error) < config.settleDistance) break;
+
+            const double linear = std::clamp<double>(config.linear->update(error), -config.maxOutput, config.maxOutput);
+            const double angular = config.angular->update(headingError);
+            config.output(linear + angular, linear - angular);
+            co_await nextTick();
+        }
+    }
+
+    Command turn(MotionConfig &config, Angle target, std::uint32_t timeout)
+    {
+        OutputGuard guard{config.output};
+        config.angular->reset();
+        const std::uint32_t startTime = pros::millis();
+
+        while (pros::millis() - startTime < timeout) {
+            Position current = config.odom->getPosition();
+            const double error = target.minimumAngleDifference(current.theta).getAngle();
+            if (fabs(error) < config.settleAngle) break;
+
+            const double angular = std::clamp<double>(config.angular->update(error), -config.maxOutput, config.maxOutput);
+            config.output(angular, -angular);
+            co_await nextTick();
+        }
+    }
+};
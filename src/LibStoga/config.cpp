@@ -0,0 +1,110 @@
+#include "config.h"
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+namespace ls {
+    std::vector<std::int8_t> usedPorts(const PortList& ports)
+    {
+        std::vector<std::int8_t> used;
+        for (std::int8_t port : ports) {
+            if (port != 0) used.push_back(port);
+        }
+        return used;
+    }
+}
+
+namespace ls::detail {
+    namespace {
+        char* trim(char* text)
+        {
+            while (std::isspace(static_cast<unsigned char>(*text))) text++;
+            char* end = text + std::strlen(text);
+            while (end > text && std::isspace(static_cast<unsigned char>(end[-1]))) end--;
+            *end = '\0';
+            return text;
+        }
+
+        // parses a whole integer, nothing but spaces may follow it.
+        bool parseInteger(const char* text, long& out, const char** rest = nullptr)
+        {
+            char* end;
+            errno = 0;
+            out = std::strtol(text, &end, 10);
+            if (end == text || errno != 0) return false;
+            if (rest != nullptr) {
+                *rest = end;
+                return true;
+            }
+            while (std::isspace(static_cast<unsigned char>(*end))) end++;
+            return *end == '\0';
+        }
+    }
+
+    LineKind splitConfigLine(char* line, char*& key, char*& value)
+    {
+        char* comment = std::strchr(line, '#');
+        if (comment != nullptr) *comment = '\0';
+        char* equals = std::strchr(line, '=');
+        if (equals == nullptr) return *trim(line) == '\0' ? LineKind::Blank : LineKind::Malformed;
+
+        *equals = '\0';
+        key = trim(line);
+        value = trim(equals + 1);
+        return *key == '\0' || *value == '\0' ? LineKind::Malformed : LineKind::Pair;
+    }
+
+    bool parseConfigValue(const char* text, float& out)
+    {
+        char* end;
+        errno = 0;
+        const float parsed = std::strtof(text, &end);
+        if (end == text || *end != '\0' || errno != 0 || !std::isfinite(parsed)) return false;
+        out = parsed;
+        return true;
+    }
+
+    bool parseConfigValue(const char* text, std::int8_t& out)
+    {
+        long parsed;
+        if (!parseInteger(text, parsed) || parsed < -128 || parsed > 127) return false;
+        out = static_cast<std::int8_t>(parsed);
+        return true;
+    }
+
+    bool parseConfigValue(const char* text, bool& out)
+    {
+        if (std::strcmp(text, "true") == 0 || std::strcmp(text, "1") == 0) {
+            out = true;
+            return true;
+        }
+        if (std::strcmp(text, "false") == 0 || std::strcmp(text, "0") == 0) {
+            out = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseConfigValue(const char* text, char& out)
+    {
+        if (text[0] == '\0' || text[1] != '\0') return false;
+        out = text[0];
+        return true;
+    }
+
+    bool parseConfigValue(const char* text, PortList& out)
+    {
+        PortList parsed{};
+        std::size_t count = 0;
+        while (*text != '\0') {
+            long port;
+            if (count == parsed.size() || !parseInteger(text, port, &text) || port < -128 || port > 127) return false;
+            parsed[count++] = static_cast<std::int8_t>(port);
+            while (std::isspace(static_cast<unsigned char>(*text)) || *text == ',') text++;
+        }
+        if (count == 0) return false;
+        out = parsed;
+        return true;
+    }
+}
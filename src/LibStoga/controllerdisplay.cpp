@@ -0,0 +1,143 @@
+#include "controllerdisplay.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace ls {
+    ControllerDisplay::ControllerDisplay(pros::controller_id_e_t controller, std::uint32_t period)
+        : controller(controller), period(period)
+    {
+        // the screen may show anything at boot, so every line starts out blank and dirty.
+        for (Line &line : pending) {
+            std::memset(line.data(), ' ', WIDTH);
+            line[WIDTH] = '\0';
+        }
+        dirty = (1 << LINES) - 1;
+    }
+
+    ControllerDisplay::~ControllerDisplay()
+    {
+        stop();
+    }
+
+    void ControllerDisplay::setLine(std::uint8_t line, const char *text)
+    {
+        if (line >= LINES) {
+            throw std::out_of_range("the controller only has 3 lines.");
+        }
+        Line padded;
+        std::size_t i = 0;
+        for (; i < WIDTH && text[i] != '\0'; i++) padded[i] = text[i];
+        for (; i < WIDTH; i++) padded[i] = ' ';
+        padded[WIDTH] = '\0';
+
+        std::lock_guard<pros::Mutex> lock(mutex);
+        if (padded == pending[line]) {
+            merged++;
+            return;
+        }
+        if (dirty & (1 << line)) merged++; // replaces an update that was never sent
+        pending[line] = padded;
+        if (padded == shown[line]) {
+            dirty &= ~(1 << line);
+        } else {
+            dirty |= 1 << line;
+        }
+    }
+
+    void ControllerDisplay::print(std::uint8_t line, const char *format, ...)
+    {
+        char text[WIDTH + 1];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        setLine(line, text);
+    }
+
+    void ControllerDisplay::clear()
+    {
+        for (std::uint8_t line = 0; line < LINES; line++) setLine(line, "");
+    }
+
+    void ControllerDisplay::rumble(const char *pattern)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        if (rumblePending) merged++;
+        std::strncpy(rumblePattern.data(), pattern, MAX_RUMBLE);
+        rumblePattern[MAX_RUMBLE] = '\0';
+        rumblePending = true;
+    }
+
+    void ControllerDisplay::start()
+    {
+        if (running) return;
+        running = true;
+        task = std::make_unique<pros::Task>([this]() { loop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "controller display");
+    }
+
+    void ControllerDisplay::stop()
+    {
+        if (!running) return;
+        running = false;
+        task->join();
+        task.reset();
+    }
+
+    void ControllerDisplay::loop()
+    {
+        std::uint32_t now = pros::millis();
+        while (running) {
+            sendNext();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    bool ControllerDisplay::sendNext()
+    {
+        // copy what to send under the lock, the radio write itself can be slow.
+        bool isRumble = false;
+        std::uint8_t line = 0;
+        Line text;
+        std::array<char, MAX_RUMBLE + 1> pattern;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            if (rumblePending) {
+                isRumble = true;
+                pattern = rumblePattern;
+            } else if (dirty != 0) {
+                while (!(dirty & (1 << nextLine))) nextLine = (nextLine + 1) % LINES;
+                line = nextLine;
+                nextLine = (nextLine + 1) % LINES;
+                text = pending[line];
+            } else {
+                return false;
+            }
+        }
+
+        const bool sent = isRumble ? controller.rumble(pattern.data()) == 1 : controller.set_text(line, 0, text.data()) == 1;
+        if (!sent) return false; // busy or disconnected, still queued for the next period.
+        writes++;
+
+        std::lock_guard<pros::Mutex> lock(mutex);
+        if (isRumble) {
+            if (pattern == rumblePattern) rumblePending = false;
+        } else {
+            shown[line] = text;
+            if (pending[line] == text) dirty &= ~(1 << line);
+        }
+        return true;
+    }
+
+    std::uint32_t ControllerDisplay::getWrites() const
+    {
+        return writes;
+    }
+
+    std::uint32_t ControllerDisplay::getMerged() const
+    {
+        return merged;
+    }
+}
@@ -0,0 +1,111 @@
+#include "drive.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace ls {
+    JoystickCurve::JoystickCurve(CurveType type, float gain, std::uint8_t deadband)
+    {
+        if (deadband >= 127) {
+            throw std::invalid_argument("deadband must be in between [0, 127).");
+        }
+        if (type == CurveType::Cubic && (gain < 0 || gain > 1)) {
+            throw std::invalid_argument("cubic gain must be in between [0, 1].");
+        }
+        if (type == CurveType::Exponential && gain <= 0) {
+            throw std::invalid_argument("exponential gain must be positive.");
+        }
+
+        for (int raw = -128; raw <= 127; raw++) {
+            const int magnitude = std::abs(raw) > 127 ? 127 : std::abs(raw);
+            float out = 0;
+            if (magnitude > deadband) {
+                const float x = static_cast<float>(magnitude - deadband) / (127 - deadband); // (0, 1]
+                switch (type) {
+                    case CurveType::Linear:
+                        out = x;
+                        break;
+                    case CurveType::Cubic:
+                        out = (1 - gain) * x + gain * x * x * x;
+                        break;
+                    case CurveType::Exponential:
+                        out = std::expm1(gain * x) / std::expm1(gain);
+                        break;
+                }
+            }
+            table[static_cast<std::uint8_t>(raw + 128)] = raw < 0 ? -out : out;
+        }
+    }
+
+    SlewLimiter::SlewLimiter(float accelRate, float decelRate)
+        : accelRate(accelRate), decelRate(decelRate)
+    {
+        if (accelRate <= 0 || decelRate <= 0) {
+            throw std::invalid_argument("slew rates must be positive.");
+        }
+    }
+
+    float SlewLimiter::update(float target, float dt)
+    {
+        const bool sameSide = (value >= 0) == (target >= 0) || value == 0;
+        const float absValue = value < 0 ? -value : value;
+        const float absTarget = target < 0 ? -target : target;
+        if (!sameSide) {
+            // reversing: only slow down this update, the other side is reached on later ones.
+            const float step = decelRate * dt;
+            value = absValue <= step ? 0 : value - (value > 0 ? step : -step);
+            return value;
+        }
+        const float sign = target > 0 || (target == 0 && value > 0) ? 1 : -1;
+        const float maxStep = (absTarget > absValue ? accelRate : decelRate) * dt;
+        const float delta = absTarget - absValue;
+        const float limited = delta > maxStep ? maxStep : (delta < -maxStep ? -maxStep : delta);
+        value = sign * (absValue + limited);
+        return value;
+    }
+
+    void SlewLimiter::reset(float v)
+    {
+        value = v;
+    }
+
+    float SlewLimiter::get() const
+    {
+        return value;
+    }
+
+    TractionControl::TractionControl(TractionConfig config)
+        : config(config) {}
+
+    void TractionControl::update(float wheelSpeed, float groundSpeed, float current)
+    {
+        const float absWheel = wheelSpeed < 0 ? -wheelSpeed : wheelSpeed;
+        // ground speed measured along the wheel's direction, negative if the side is being dragged backwards.
+        const float along = wheelSpeed < 0 ? -groundSpeed : groundSpeed;
+        slipping = absWheel > config.minSpeed && current > config.currentThreshold
+            && absWheel - along > config.slipRatio * absWheel;
+
+        if (slipping) {
+            scale -= config.backoff;
+            if (scale < config.minScale) scale = config.minScale;
+        } else {
+            scale += config.recovery;
+            if (scale > 1) scale = 1;
+        }
+    }
+
+    float TractionControl::getScale() const
+    {
+        return scale;
+    }
+
+    bool TractionControl::isSlipping() const
+    {
+        return slipping;
+    }
+
+    void TractionControl::reset()
+    {
+        scale = 1;
+        slipping = false;
+    }
+}
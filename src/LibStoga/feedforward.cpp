@@ -0,0 +1,106 @@
+#include "feedforward.h"
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+namespace ls {
+    FeedforwardFit::FeedforwardFit(double minVelocity)
+        : minVelocity(minVelocity) {}
+
+    void FeedforwardFit::add(double voltage, double velocity, double acceleration)
+    {
+        if (std::fabs(velocity) < minVelocity) return;
+        const double x[3] = {velocity > 0 ? 1.0 : (velocity < 0 ? -1.0 : 0.0), velocity, acceleration};
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) xtx[i][j] += x[i] * x[j];
+            xty[i] += x[i] * voltage;
+        }
+        sumY += voltage;
+        sumYY += voltage * voltage;
+        count++;
+    }
+
+    FeedforwardGains FeedforwardFit::solve() const
+    {
+        // Gaussian elimination with partial pivoting on [X^T X | X^T y].
+        double m[3][4];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) m[i][j] = xtx[i][j];
+            m[i][3] = xty[i];
+        }
+        double scale = 0;
+        for (int i = 0; i < 3; i++) scale = std::fmax(scale, std::fabs(m[i][i]));
+        if (scale == 0) return {};
+
+        for (int col = 0; col < 3; col++) {
+            int pivot = col;
+            for (int row = col + 1; row < 3; row++) {
+                if (std::fabs(m[row][col]) > std::fabs(m[pivot][col])) pivot = row;
+            }
+            if (std::fabs(m[pivot][col]) < 1e-12 * scale) return {}; // singular, ex. acceleration never varied
+            if (pivot != col) {
+                for (int j = 0; j < 4; j++) std::swap(m[col][j], m[pivot][j]);
+            }
+            for (int row = col + 1; row < 3; row++) {
+                const double factor = m[row][col] / m[col][col];
+                for (int j = col; j < 4; j++) m[row][j] -= factor * m[col][j];
+            }
+        }
+        double k[3];
+        for (int i = 2; i >= 0; i--) {
+            double sum = m[i][3];
+            for (int j = i + 1; j < 3; j++) sum -= m[i][j] * k[j];
+            k[i] = sum / m[i][i];
+        }
+        return {k[0], k[1], k[2]};
+    }
+
+    double FeedforwardFit::getRSquared() const
+    {
+        if (count < 2) return 0;
+        const FeedforwardGains g = solve();
+        const double k[3] = {g.kS, g.kV, g.kA};
+        // residual sum of squares from the normal equations: y^T y - 2 k^T X^T y + k^T X^T X k
+        double fitted = 0;
+        for (int i = 0; i < 3; i++) {
+            fitted -= 2 * k[i] * xty[i];
+            for (int j = 0; j < 3; j++) fitted += k[i] * xtx[i][j] * k[j];
+        }
+        const double residual = sumYY + fitted;
+        const double total = sumYY - sumY * sumY / count;
+        return total > 0 ? 1 - residual / total : 0;
+    }
+
+    std::size_t FeedforwardFit::getCount() const
+    {
+        return count;
+    }
+
+    void FeedforwardFit::reset()
+    {
+        *this = FeedforwardFit(minVelocity);
+    }
+
+    bool saveFeedforward(const char *path, const FeedforwardGains &linear, const FeedforwardGains &angular)
+    {
+        std::FILE *file = std::fopen(path, "w");
+        if (file == nullptr) return false;
+        std::fprintf(file, "linear %.9g %.9g %.9g\n", linear.kS, linear.kV, linear.kA);
+        std::fprintf(file, "angular %.9g %.9g %.9g\n", angular.kS, angular.kV, angular.kA);
+        return std::fclose(file) == 0;
+    }
+
+    bool loadFeedforward(const char *path, FeedforwardGains &linear, FeedforwardGains &angular)
+    {
+        std::FILE *file = std::fopen(path, "r");
+        if (file == nullptr) return false;
+        FeedforwardGains l, a;
+        const bool ok = std::fscanf(file, " linear %lf %lf %lf", &l.kS, &l.kV, &l.kA) == 3
+            && std::fscanf(file, " angular %lf %lf %lf", &a.kS, &a.kV, &a.kA) == 3;
+        std::fclose(file);
+        if (!ok) return false;
+        linear = l;
+        angular = a;
+        return true;
+    }
+}
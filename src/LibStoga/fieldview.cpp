@@ -0,0 +1,353 @@
+#include "fieldview.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include "numeric.h"
+
+namespace ls {
+    namespace {
+        constexpr ScreenRect FIELD_RECT{0, 0, FieldView::FIELD_PIXELS - 1, FieldView::FIELD_PIXELS - 1};
+        constexpr std::int16_t TEXT_X = FieldView::FIELD_PIXELS + 12;
+        constexpr std::int16_t TEXT_Y[3] = {30, 70, 110};
+        constexpr std::int16_t TEXT_HEIGHT = 24;
+        constexpr std::int16_t TARGET_RADIUS = 3;
+        constexpr int TILES = 6; // the field is 6x6 tiles
+
+        constexpr std::uint32_t FIELD_COLOR = 0x303030;
+        constexpr std::uint32_t GRID_COLOR = 0x585858;
+        constexpr std::uint32_t PATH_COLOR = 0xFFD700;
+        constexpr std::uint32_t TARGET_COLOR = 0x00C853;
+        constexpr std::uint32_t ROBOT_COLOR = 0xFFFFFF;
+        constexpr std::uint32_t HEADING_COLOR = 0xFF3030;
+
+        // Liang-Barsky: draws only the part of the line inside 'clip', so nothing outside a dirty rectangle is touched.
+        void drawClippedLine(double x0, double y0, double x1, double y1, const ScreenRect &clip)
+        {
+            const double dx = x1 - x0;
+            const double dy = y1 - y0;
+            double t0 = 0;
+            double t1 = 1;
+            const double p[4] = {-dx, dx, -dy, dy};
+            const double q[4] = {x0 - clip.x0, clip.x1 - x0, y0 - clip.y0, clip.y1 - y0};
+            for (int i = 0; i < 4; i++) {
+                if (p[i] == 0) {
+                    if (q[i] < 0) return;
+                    continue;
+                }
+                const double t = q[i] / p[i];
+                if (p[i] < 0) {
+                    if (t > t1) return;
+                    if (t > t0) t0 = t;
+                } else {
+                    if (t < t0) return;
+                    if (t < t1) t1 = t;
+                }
+            }
+            pros::screen::draw_line(static_cast<std::int16_t>(std::lround(x0 + t0 * dx)), static_cast<std::int16_t>(std::lround(y0 + t0 * dy)),
+                static_cast<std::int16_t>(std::lround(x0 + t1 * dx)), static_cast<std::int16_t>(std::lround(y0 + t1 * dy)));
+        }
+    }
+
+    void DirtyRegions::add(ScreenRect rect)
+    {
+        if (rect.empty()) return;
+        // absorb every rectangle it overlaps, which can make it overlap others, so repeat until nothing changes.
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (std::size_t i = 0; i < count; i++) {
+                if (!rects[i].intersects(rect)) continue;
+                rect = rect.merge(rects[i]);
+                rects[i] = rects[--count];
+                merged = true;
+                break;
+            }
+        }
+        if (count < MAX_RECTS) {
+            rects[count++] = rect;
+            return;
+        }
+        std::size_t best = 0;
+        std::int32_t bestGrowth = rects[0].merge(rect).area() - rects[0].area();
+        for (std::size_t i = 1; i < count; i++) {
+            const std::int32_t growth = rects[i].merge(rect).area() - rects[i].area();
+            if (growth < bestGrowth) {
+                best = i;
+                bestGrowth = growth;
+            }
+        }
+        const ScreenRect grown = rects[best].merge(rect);
+        rects[best] = rects[--count];
+        add(grown);
+    }
+
+    void DirtyRegions::clear()
+    {
+        count = 0;
+    }
+
+    std::size_t DirtyRegions::size() const
+    {
+        return count;
+    }
+
+    std::int32_t DirtyRegions::area() const
+    {
+        std::int32_t total = 0;
+        for (std::size_t i = 0; i < count; i++) total += rects[i].area();
+        return total;
+    }
+
+    FieldView::FieldView(double startX, double startY, double robotSize, std::uint32_t period)
+        : startX(startX), startY(startY), robotSize(robotSize), period(period) {}
+
+    FieldView::~FieldView()
+    {
+        stop();
+    }
+
+    void FieldView::setPose(const Position &p)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        pose = p;
+    }
+
+    void FieldView::setTarget(double x, double y)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        hasTarget = true;
+        targetX = x;
+        targetY = y;
+    }
+
+    void FieldView::clearTarget()
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        hasTarget = false;
+    }
+
+    void FieldView::setPath(std::span<const Position> points)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        pathSize = points.size() < MAX_PATH ? points.size() : MAX_PATH;
+        for (std::size_t i = 0; i < pathSize; i++) path[i] = points[i];
+        pathChanged = true;
+    }
+
+    void FieldView::clearPath()
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        pathSize = 0;
+        pathChanged = true;
+    }
+
+    void FieldView::invalidate()
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        fullRedraw = true;
+    }
+
+    void FieldView::start()
+    {
+        if (running) return;
+        invalidate();
+        running = true;
+        task = std::make_unique<pros::Task>([this]() { loop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "field view");
+    }
+
+    void FieldView::stop()
+    {
+        if (!running) return;
+        running = false;
+        task->join();
+        task.reset();
+    }
+
+    std::uint32_t FieldView::getFrames() const
+    {
+        return frames;
+    }
+
+    std::uint64_t FieldView::getRedrawnPixels() const
+    {
+        return pixels;
+    }
+
+    void FieldView::loop()
+    {
+        std::uint32_t now = pros::millis();
+        while (running) {
+            frame();
+            pros::Task::delay_until(&now, period);
+        }
+    }
+
+    FieldView::Point FieldView::toScreen(double x, double y) const
+    {
+        constexpr double scale = FIELD_PIXELS / FIELD_INCHES;
+        const double px = std::clamp((startX + x) * scale, -1000.0, 1000.0);
+        const double py = std::clamp((FIELD_PIXELS - 1) - (startY + y) * scale, -1000.0, 1000.0);
+        return {static_cast<std::int16_t>(std::lround(px)), static_cast<std::int16_t>(std::lround(py))};
+    }
+
+    void FieldView::frame()
+    {
+        Scene next{};
+        Position p;
+        bool full;
+        bool pathDirty;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            p = pose;
+            next.hasTarget = hasTarget;
+            next.target = toScreen(targetX, targetY);
+            pathDirty = pathChanged;
+            if (pathChanged) {
+                next.pathSize = pathSize;
+                for (std::size_t i = 0; i < pathSize; i++) next.path[i] = toScreen(path[i].X, path[i].Y);
+            }
+            full = fullRedraw;
+            pathChanged = false;
+            fullRedraw = false;
+        }
+        if (!pathDirty) {
+            next.pathSize = drawn.pathSize;
+            next.path = drawn.path;
+        }
+
+        // bearing: 0 is +Y (up on screen), turning clockwise.
+        double s, c;
+        Numeric<double>::sincos(p.theta.convertToRadians(), s, c);
+        const double half = robotSize / 2;
+        const double corners[4][2] = {{half, half}, {-half, half}, {-half, -half}, {half, -half}}; // (right, forward)
+        for (int i = 0; i < 4; i++) {
+            const double x = p.X + corners[i][0] * c + corners[i][1] * s;
+            const double y = p.Y - corners[i][0] * s + corners[i][1] * c;
+            next.robot[i] = toScreen(x, y);
+        }
+        next.robot[4] = toScreen(p.X + half * s, p.Y + half * c);
+        next.center = toScreen(p.X, p.Y);
+
+        dirty.clear();
+        if (full) {
+            dirty.add(FIELD_RECT);
+            pros::screen::set_eraser(pros::Color::black);
+            pros::screen::erase_rect(FIELD_PIXELS, 0, 479, 239);
+            shownText = {-32768, -32768, -32768};
+        } else {
+            bool robotMoved = false;
+            for (int i = 0; i < 5; i++) {
+                robotMoved |= next.robot[i].x != drawn.robot[i].x || next.robot[i].y != drawn.robot[i].y;
+            }
+            if (robotMoved) {
+                dirty.add(robotBounds(drawn));
+                dirty.add(robotBounds(next));
+            }
+            if (next.hasTarget != drawn.hasTarget || next.target.x != drawn.target.x || next.target.y != drawn.target.y) {
+                dirty.add(targetBounds(drawn));
+                dirty.add(targetBounds(next));
+            }
+            if (pathDirty) {
+                dirty.add(pathBounds(drawn));
+                dirty.add(pathBounds(next));
+            }
+        }
+
+        std::int32_t area = 0;
+        for (const ScreenRect &rect : dirty) {
+            const ScreenRect clip = rect.clip(FIELD_RECT);
+            if (clip.empty()) continue;
+            draw(next, clip);
+            area += clip.area();
+        }
+        drawn = next;
+        drawText(p);
+        if (area > 0) {
+            frames++;
+            pixels += area;
+        }
+    }
+
+    void FieldView::draw(const Scene &scene, const ScreenRect &clip) const
+    {
+        pros::screen::set_pen(FIELD_COLOR);
+        pros::screen::fill_rect(clip.x0, clip.y0, clip.x1, clip.y1);
+
+        pros::screen::set_pen(GRID_COLOR);
+        for (int i = 1; i < TILES; i++) {
+            const std::int16_t at = i * FIELD_PIXELS / TILES;
+            if (at >= clip.x0 && at <= clip.x1) pros::screen::draw_line(at, clip.y0, at, clip.y1);
+            if (at >= clip.y0 && at <= clip.y1) pros::screen::draw_line(clip.x0, at, clip.x1, at);
+        }
+
+        pros::screen::set_pen(PATH_COLOR);
+        for (std::size_t i = 1; i < scene.pathSize; i++) {
+            const Point a = scene.path[i - 1];
+            const Point b = scene.path[i];
+            drawClippedLine(a.x, a.y, b.x, b.y, clip);
+        }
+
+        if (scene.hasTarget && targetBounds(scene).intersects(clip)) {
+            pros::screen::set_pen(TARGET_COLOR);
+            pros::screen::fill_circle(scene.target.x, scene.target.y, TARGET_RADIUS);
+        }
+
+        if (robotBounds(scene).intersects(clip)) {
+            pros::screen::set_pen(ROBOT_COLOR);
+            for (int i = 0; i < 4; i++) {
+                const Point a = scene.robot[i];
+                const Point b = scene.robot[(i + 1) % 4];
+                drawClippedLine(a.x, a.y, b.x, b.y, clip);
+            }
+            pros::screen::set_pen(HEADING_COLOR);
+            drawClippedLine(scene.center.x, scene.center.y, scene.robot[4].x, scene.robot[4].y, clip);
+        }
+    }
+
+    void FieldView::drawText(const Position &p)
+    {
+        const std::int16_t values[3] = {
+            static_cast<std::int16_t>(std::lround(std::clamp(p.X * 10, -32000.0, 32000.0))),
+            static_cast<std::int16_t>(std::lround(std::clamp(p.Y * 10, -32000.0, 32000.0))),
+            static_cast<std::int16_t>(std::lround(p.theta.normalize()) % 360)
+        };
+        for (int i = 0; i < 3; i++) {
+            if (values[i] == shownText[i]) continue;
+            shownText[i] = values[i];
+            pros::screen::set_eraser(pros::Color::black);
+            pros::screen::erase_rect(TEXT_X, TEXT_Y[i], 479, TEXT_Y[i] + TEXT_HEIGHT);
+            pros::screen::set_pen(pros::Color::white);
+            if (i == 2) {
+                pros::screen::print(pros::E_TEXT_MEDIUM, TEXT_X, TEXT_Y[i], "H %d deg", values[i]);
+            } else {
+                pros::screen::print(pros::E_TEXT_MEDIUM, TEXT_X, TEXT_Y[i], "%c %.1f in", i == 0 ? 'X' : 'Y', values[i] / 10.0);
+            }
+        }
+    }
+
+    ScreenRect FieldView::robotBounds(const Scene &scene)
+    {
+        ScreenRect bounds{scene.robot[0].x, scene.robot[0].y, scene.robot[0].x, scene.robot[0].y};
+        for (int i = 1; i < 5; i++) {
+            bounds = bounds.merge({scene.robot[i].x, scene.robot[i].y, scene.robot[i].x, scene.robot[i].y});
+        }
+        return {static_cast<std::int16_t>(bounds.x0 - 1), static_cast<std::int16_t>(bounds.y0 - 1),
+            static_cast<std::int16_t>(bounds.x1 + 1), static_cast<std::int16_t>(bounds.y1 + 1)};
+    }
+
+    ScreenRect FieldView::pathBounds(const Scene &scene)
+    {
+        ScreenRect bounds;
+        for (std::size_t i = 0; i < scene.pathSize; i++) {
+            bounds = bounds.merge({scene.path[i].x, scene.path[i].y, scene.path[i].x, scene.path[i].y});
+        }
+        return bounds;
+    }
+
+    ScreenRect FieldView::targetBounds(const Scene &scene)
+    {
+        if (!scene.hasTarget) return {};
+        return {static_cast<std::int16_t>(scene.target.x - TARGET_RADIUS - 1), static_cast<std::int16_t>(scene.target.y - TARGET_RADIUS - 1),
+            static_cast<std::int16_t>(scene.target.x + TARGET_RADIUS + 1), static_cast<std::int16_t>(scene.target.y + TARGET_RADIUS + 1)};
+    }
+}
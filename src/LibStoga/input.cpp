@@ -0,0 +1,117 @@
+#include "input.h"
+#include <stdexcept>
+
+namespace ls {
+    namespace {
+        ControllerSnapshot read(pros::Controller &controller)
+        {
+            ControllerSnapshot raw;
+            raw.connected = controller.is_connected() == 1;
+            if (!raw.connected) return raw;
+            for (std::size_t i = 0; i < AXIS_COUNT; i++) {
+                raw.axes[i] = static_cast<std::int8_t>(controller.get_analog(static_cast<pros::controller_analog_e_t>(i)));
+            }
+            for (std::size_t i = 0; i < BUTTON_COUNT; i++) {
+                const auto digital = static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + i);
+                if (controller.get_digital(digital) == 1) raw.buttons |= 1u << i;
+            }
+            return raw;
+        }
+
+        constexpr std::uint8_t slot(ButtonEvent event)
+        {
+            return static_cast<std::uint8_t>(event);
+        }
+    }
+
+    Input::Input(InputTiming timing)
+        : timing(timing) {}
+
+    void Input::on(ControllerId controller, Button button, ButtonEvent event, Callback callback)
+    {
+        if (bindingCount == MAX_BINDINGS) {
+            throw std::out_of_range("too many input bindings.");
+        }
+        bindings[bindingCount++] = {std::move(callback), controller, button, event};
+    }
+
+    void Input::update()
+    {
+        const std::uint32_t now = pros::millis();
+        update(ControllerId::Master, read(master), now);
+        update(ControllerId::Partner, read(partner), now);
+    }
+
+    void Input::update(ControllerId controller, const ControllerSnapshot &raw, std::uint32_t now)
+    {
+        ControllerState &state = states[static_cast<std::uint8_t>(controller)];
+        state.events = {};
+        state.snapshot.axes = raw.axes;
+        state.snapshot.connected = raw.connected;
+
+        for (std::size_t i = 0; i < BUTTON_COUNT; i++) {
+            const std::uint16_t mask = 1u << i;
+            const bool down = raw.buttons & mask;
+            ButtonTimes &times = state.times[i];
+
+            if (down != bool(state.snapshot.buttons & mask) && now - times.changed >= timing.debounce) {
+                times.changed = now;
+                if (down) {
+                    state.snapshot.buttons |= mask;
+                    state.events[slot(ButtonEvent::Press)] |= mask;
+                    if (times.tapped && now - times.pressed <= timing.doubleTap) {
+                        state.events[slot(ButtonEvent::DoubleTap)] |= mask;
+                        times.tapped = false; // a third tap starts a new double tap
+                    } else {
+                        times.tapped = true;
+                    }
+                    times.pressed = now;
+                    times.held = false;
+                } else {
+                    state.snapshot.buttons &= ~mask;
+                    state.events[slot(ButtonEvent::Release)] |= mask;
+                }
+            }
+
+            if ((state.snapshot.buttons & mask) && !times.held && now - times.pressed >= timing.hold) {
+                state.events[slot(ButtonEvent::Hold)] |= mask;
+                times.held = true;
+                times.tapped = false; // a hold is not the first half of a double tap
+            }
+        }
+        dispatch(controller);
+    }
+
+    void Input::dispatch(ControllerId controller)
+    {
+        const ControllerState &state = states[static_cast<std::uint8_t>(controller)];
+        if ((state.events[0] | state.events[1] | state.events[2] | state.events[3]) == 0) return;
+        for (std::size_t i = 0; i < bindingCount; i++) {
+            const Binding &binding = bindings[i];
+            if (binding.controller != controller) continue;
+            if (state.events[slot(binding.event)] & (1u << static_cast<std::uint8_t>(binding.button))) {
+                binding.callback();
+            }
+        }
+    }
+
+    const ControllerSnapshot& Input::get(ControllerId controller) const
+    {
+        return states[static_cast<std::uint8_t>(controller)].snapshot;
+    }
+
+    std::int8_t Input::getAxis(ControllerId controller, Axis axis) const
+    {
+        return get(controller).axis(axis);
+    }
+
+    bool Input::isDown(ControllerId controller, Button button) const
+    {
+        return get(controller).isDown(button);
+    }
+
+    bool Input::was(ControllerId controller, Button button, ButtonEvent event) const
+    {
+        return states[static_cast<std::uint8_t>(controller)].events[slot(event)] & (1u << static_cast<std::uint8_t>(button));
+    }
+}
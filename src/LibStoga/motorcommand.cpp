@@ -0,0 +1,103 @@
+#include "motorcommand.h"
+#include <stdexcept>
+
+namespace ls {
+    MotorCommandBuffer::MotorCommandBuffer(std::uint32_t refreshPeriod)
+        : refreshPeriod(refreshPeriod) {}
+
+    MotorCommandBuffer::Handle MotorCommandBuffer::add(pros::v5::AbstractMotor &motor)
+    {
+        for (std::uint8_t i = 0; i < count; i++) {
+            if (motors[i] == &motor) return i;
+        }
+        if (count == MAX_MOTORS) {
+            throw std::out_of_range("too many motors registered to one command buffer.");
+        }
+        motors[count] = &motor;
+        return count++;
+    }
+
+    void MotorCommandBuffer::setVoltage(Handle motor, std::int32_t millivolts)
+    {
+        wanted[motor].mode = Mode::Voltage;
+        wanted[motor].value = millivolts;
+    }
+
+    void MotorCommandBuffer::setVelocity(Handle motor, std::int32_t rpm)
+    {
+        wanted[motor].mode = Mode::Velocity;
+        wanted[motor].value = rpm;
+    }
+
+    void MotorCommandBuffer::brake(Handle motor)
+    {
+        wanted[motor].mode = Mode::Brake;
+        wanted[motor].value = 0;
+    }
+
+    void MotorCommandBuffer::setBrakeMode(Handle motor, pros::v5::MotorBrake mode)
+    {
+        wanted[motor].brakeMode = mode;
+    }
+
+    void MotorCommandBuffer::flush()
+    {
+        flushes++;
+        const bool refresh = forceNext || (refreshPeriod != 0 && flushes % refreshPeriod == 0);
+        forceNext = false;
+
+        for (std::uint8_t i = 0; i < count; i++) {
+            const Command &want = wanted[i];
+            Command &last = sent[i];
+            pros::v5::AbstractMotor *motor = motors[i];
+
+            // brake mode first, so a brake() in the same flush uses the new mode.
+            if (want.brakeMode != pros::v5::MotorBrake::invalid) {
+                if (refresh || want.brakeMode != last.brakeMode) {
+                    motor->set_brake_mode_all(want.brakeMode);
+                    last.brakeMode = want.brakeMode;
+                    writes++;
+                } else {
+                    suppressed++;
+                }
+            }
+
+            if (want.mode == Mode::None) continue;
+            if (!refresh && want.sameMotion(last)) {
+                suppressed++;
+                continue;
+            }
+            switch (want.mode) {
+                case Mode::Voltage:
+                    motor->move_voltage(want.value);
+                    break;
+                case Mode::Velocity:
+                    motor->move_velocity(want.value);
+                    break;
+                case Mode::Brake:
+                    motor->brake();
+                    break;
+                case Mode::None:
+                    break;
+            }
+            last.mode = want.mode;
+            last.value = want.value;
+            writes++;
+        }
+    }
+
+    void MotorCommandBuffer::invalidate()
+    {
+        forceNext = true;
+    }
+
+    std::uint32_t MotorCommandBuffer::getWrites() const
+    {
+        return writes;
+    }
+
+    std::uint32_t MotorCommandBuffer::getSuppressed() const
+    {
+        return suppressed;
+    }
+}
@@ -0,0 +1,170 @@
+#include "motormonitor.h"
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace ls {
+    namespace {
+        constexpr std::uint8_t HOT_BIT = 1;
+        constexpr std::uint8_t OVER_TEMP_BIT = 2;
+        constexpr std::uint8_t OVER_CURRENT_BIT = 4;
+
+        void record(HealthStat &stat, float value, bool first, float smoothing)
+        {
+            stat.last = value;
+            if (first) {
+                stat.min = value;
+                stat.max = value;
+                stat.average = value;
+                return;
+            }
+            if (value < stat.min) stat.min = value;
+            if (value > stat.max) stat.max = value;
+            stat.average += smoothing * (value - stat.average);
+        }
+    }
+
+    MotorMonitor::MotorMonitor(std::uint32_t period, float smoothing, HealthThresholds thresholds)
+        : period(period), smoothing(smoothing), thresholds(thresholds)
+    {
+        if (smoothing <= 0 || smoothing > 1) {
+            throw std::invalid_argument("smoothing must be in between (0, 1].");
+        }
+        for (auto &scale : powerScale) scale = 1;
+    }
+
+    MotorMonitor::~MotorMonitor()
+    {
+        stop();
+    }
+
+    MotorMonitor::Handle MotorMonitor::add(pros::v5::AbstractMotor &motor)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        const std::uint8_t first = count;
+        const std::int8_t size = motor.size();
+        if (size <= 0 || first + size > static_cast<int>(MAX_MOTORS)) {
+            throw std::out_of_range("too many motors registered to one monitor.");
+        }
+        for (std::int8_t i = 0; i < size; i++) {
+            entries[first + i] = {&motor, static_cast<std::uint8_t>(i)};
+        }
+        count = first + size;
+        return first;
+    }
+
+    void MotorMonitor::onEvent(EventCallback cb)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        callback = std::move(cb);
+    }
+
+    void MotorMonitor::start()
+    {
+        if (running) return;
+        running = true;
+        task = std::make_unique<pros::Task>([this]() { loop(); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "motor monitor");
+    }
+
+    void MotorMonitor::stop()
+    {
+        if (!running) return;
+        running = false;
+        task->join();
+        task.reset();
+    }
+
+    void MotorMonitor::loop()
+    {
+        std::uint32_t now = pros::millis();
+        Handle next = 0;
+        while (running) {
+            const std::uint8_t n = count;
+            if (n == 0) {
+                pros::Task::delay_until(&now, period);
+                continue;
+            }
+            if (next >= n) next = 0;
+            sample(next++);
+            // one motor per wake, spread over the period.
+            pros::Task::delay_until(&now, period / n > 0 ? period / n : 1);
+        }
+    }
+
+    void MotorMonitor::sample(Handle motor)
+    {
+        const Entry entry = entries[motor];
+        const float temperature = static_cast<float>(entry.motor->get_temperature(entry.index));
+        if (!std::isfinite(temperature)) return; // unplugged, PROS_ERR_F
+        const float current = static_cast<float>(entry.motor->get_current_draw(entry.index));
+        const float efficiency = static_cast<float>(entry.motor->get_efficiency(entry.index));
+        const float voltage = static_cast<float>(entry.motor->get_voltage(entry.index));
+        const bool overTemp = entry.motor->is_over_temp(entry.index) == 1;
+        const bool overCurrent = entry.motor->is_over_current(entry.index) == 1;
+
+        float scale = 1;
+        if (temperature >= thresholds.cutoffTemperature) {
+            scale = thresholds.minPowerScale;
+        } else if (temperature > thresholds.derateTemperature) {
+            const float t = (temperature - thresholds.derateTemperature) / (thresholds.cutoffTemperature - thresholds.derateTemperature);
+            scale = 1 - t * (1 - thresholds.minPowerScale);
+        }
+        powerScale[motor] = scale;
+
+        const std::uint8_t active = (temperature > thresholds.derateTemperature ? HOT_BIT : 0)
+            | (overTemp ? OVER_TEMP_BIT : 0) | (overCurrent ? OVER_CURRENT_BIT : 0);
+        std::uint8_t raised;
+        bool recovered;
+        EventCallback cb;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            MotorHealth &h = health[motor];
+            const bool first = h.samples == 0;
+            record(h.temperature, temperature, first, smoothing);
+            record(h.current, current, first, smoothing);
+            record(h.efficiency, efficiency, first, smoothing);
+            record(h.voltage, voltage, first, smoothing);
+            h.overTemp = overTemp;
+            h.overCurrent = overCurrent;
+            h.samples++;
+
+            raised = active & ~alerts[motor];
+            recovered = active == 0 && alerts[motor] != 0;
+            alerts[motor] = recovered ? 0 : (alerts[motor] | active);
+            if (raised || recovered) cb = callback;
+        }
+
+        // outside the lock, so the callback can call getHealth().
+        if (!cb) return;
+        if (raised & HOT_BIT) cb(motor, HealthEvent::Hot);
+        if (raised & OVER_TEMP_BIT) cb(motor, HealthEvent::OverTemp);
+        if (raised & OVER_CURRENT_BIT) cb(motor, HealthEvent::OverCurrent);
+        if (recovered) cb(motor, HealthEvent::Recovered);
+    }
+
+    MotorHealth MotorMonitor::getHealth(Handle motor)
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        return health[motor];
+    }
+
+    float MotorMonitor::getPowerScale(Handle motor) const
+    {
+        return powerScale[motor];
+    }
+
+    float MotorMonitor::getPowerScale(Handle first, std::size_t count) const
+    {
+        float scale = 1;
+        for (std::size_t i = 0; i < count; i++) {
+            const float motor = powerScale[first + i];
+            if (motor < scale) scale = motor;
+        }
+        return scale;
+    }
+
+    std::size_t MotorMonitor::getCount() const
+    {
+        return count;
+    }
+}
@@ -0,0 +1,84 @@
+#include "motorstate.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace ls {
+    MotorStateCache::Handle MotorStateCache::add(pros::v5::AbstractMotor &motor)
+    {
+        for (std::uint8_t i = 0; i < count; i++) {
+            if (entries[i].motor == &motor) return i;
+        }
+        const std::int8_t size = motor.size();
+        if (size <= 0 || count + size > static_cast<int>(MotorStates::MAX_MOTORS)) {
+            throw std::out_of_range("too many motors registered to one state cache.");
+        }
+        const std::uint8_t first = count;
+        for (std::int8_t i = 0; i < size; i++) {
+            entries[count++] = {&motor, static_cast<std::uint8_t>(i)};
+        }
+        return first;
+    }
+
+    void MotorStateCache::refresh()
+    {
+        for (std::uint8_t i = 0; i < count; i++) {
+            const Entry &entry = entries[i];
+            states.position[i] = entry.motor->get_position(entry.index);
+            states.velocity[i] = entry.motor->get_actual_velocity(entry.index);
+            states.current[i] = entry.motor->get_current_draw(entry.index);
+            states.voltage[i] = entry.motor->get_voltage(entry.index);
+            states.readTime[i] = pros::micros();
+            states.valid[i] = std::isfinite(states.velocity[i]) && states.current[i] != PROS_ERR;
+        }
+        reads += 4 * count;
+        states.sequence++;
+        lastRefresh = pros::micros();
+    }
+
+    bool MotorStateCache::refresh(std::uint64_t maxAge)
+    {
+        if (states.sequence != 0 && pros::micros() - lastRefresh <= maxAge) return false;
+        refresh();
+        return true;
+    }
+
+    const MotorStates& MotorStateCache::getStates() const
+    {
+        return states;
+    }
+
+    double MotorStateCache::getPosition(Handle motor) const
+    {
+        return states.position[motor];
+    }
+
+    double MotorStateCache::getVelocity(Handle motor) const
+    {
+        return states.velocity[motor];
+    }
+
+    std::int32_t MotorStateCache::getCurrent(Handle motor) const
+    {
+        return states.current[motor];
+    }
+
+    std::int32_t MotorStateCache::getVoltage(Handle motor) const
+    {
+        return states.voltage[motor];
+    }
+
+    bool MotorStateCache::isValid(Handle motor) const
+    {
+        return states.valid[motor];
+    }
+
+    std::uint64_t MotorStateCache::getAge(Handle motor) const
+    {
+        return pros::micros() - states.readTime[motor];
+    }
+
+    std::uint32_t MotorStateCache::getReads() const
+    {
+        return reads;
+    }
+}
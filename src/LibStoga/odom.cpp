@@ -1,5 +1,7 @@
 #include "odom.h"
 #include "tracking.h"
+#include "ports.h"
+#include <functional>
 
 /**
  * @brief Contains all source code for abstract classes or composed ones
@@ -9,11 +11,51 @@
 namespace ls {
     void AbstractOdom::compute()
     {
-		pos.X += getDeltaX();
-		pos.Y += getDeltaY();
-		pos.theta += getDeltaAngle();
+		if (sampler == nullptr) {
+			ownSampler = std::make_unique<SensorSampler>();
+			attach(*ownSampler);
+		}
+		compute(sampler->sample());
+    }
+
+    void AbstractOdom::integrate(const Twist2<OdomScalar> &twist)
+    {
+		using N = Numeric<OdomScalar>;
+		Pose2<OdomScalar> next = pose * Pose2<OdomScalar>::exp(twist);
+		next.rotation = next.rotation.normalized();
+
+		deltaX = N::toDouble(next.y - pose.y);
+		deltaY = N::toDouble(next.x - pose.x);
+		deltaAngle = Angle::fromRadians(N::toDouble(twist.dtheta));
+		localDelta = {N::toDouble(twist.dx), N::toDouble(twist.dy), N::toDouble(twist.dtheta)};
+		pose = next;
+
+		pos.X = N::toDouble(pose.y);
+		pos.Y = N::toDouble(pose.x);
+		// accumulated instead of read back from the pose, so getAngle() keeps counting full turns
+		pos.theta += deltaAngle;
     }
 
+	double AbstractOdom::getDeltaX()
+	{
+		return deltaX;
+	}
+
+	double AbstractOdom::getDeltaY()
+	{
+		return deltaY;
+	}
+
+	Angle AbstractOdom::getDeltaAngle()
+	{
+		return deltaAngle;
+	}
+
+	Twist2<double> AbstractOdom::getLocalDelta()
+	{
+		return localDelta;
+	}
+
     double AbstractOdom::getX()
 	{
 		return pos.X;
@@ -37,16 +79,19 @@ namespace ls {
 	void AbstractOdom::resetX()
 	{
 		pos.X = 0;
+		pose.y = Numeric<OdomScalar>::from(0.0);
 	}
 
 	void AbstractOdom::resetY()
 	{
 		pos.Y = 0;
+		pose.x = Numeric<OdomScalar>::from(0.0);
 	}
 
 	void AbstractOdom::resetAngle()
 	{
 		pos.theta = 0;
+		pose.rotation = Rot2<OdomScalar>{};
 	}
 
 	void AbstractOdom::resetAll()
@@ -58,9 +103,7 @@ namespace ls {
 
 	double Position::distanceFromPoint(Position &pos) const
 	{
-		const double dx = pos.X - X;
-		const double dy = pos.Y - Y;
-		return sqrt(dx*dx + dy*dy);
+		return Numeric<double>::hypot(pos.X - X, pos.Y - Y);
 	}
 
 	double Position::distanceFromPointSigned(Position &pos) const
@@ -70,31 +113,22 @@ namespace ls {
 
 	int Position::isBehind(Position &pos) const
 	{
-		Angle a = angleToPosition(pos);
-		const Angle lower_bound = theta.getAngle() - 90;
-		const Angle upper_bound = theta.getAngle() + 90;
-
-		if (a.getAngle() == infinity()) {
+		if (pos.X == X && pos.Y == Y) {
 			return 0;
 		}
-		else if (a.getAngle() > lower_bound.normalize() && a.getAngle() < upper_bound.normalize()) {
-			return 1;
-		} 
-		else {
-			return -1;
-		}
+		// in front if the point is within 90 degrees either side of the heading.
+		const Angle offset = angleToPositionSigned(pos).minimumAngleDifference(theta);
+		return fabs(offset.convertToRadians()) < PI / 2 ? 1 : -1;
 	}
 
 	Angle Position::angleToPosition(Position &pos) const
 	{
-		Angle tor = (90 - atan2(pos.Y-Y, pos.X-X) * 57.2957795131);
-		tor = tor.normalize();
-		return tor;
+		return angleToPositionSigned(pos).wrapped(AngleWrap::Positive);
 	}
 
 	Angle Position::angleToPositionSigned(Position &pos) const
 	{
-		return (90 - atan2(pos.Y-Y, pos.X-X) * 57.2957795131);
+		return Angle::fromRadians(Numeric<double>::atan2(pos.Y-Y, pos.X-X)).toBearing();
 	}
 };
 
@@ -103,8 +137,8 @@ namespace ls {
  * 
  */
 namespace ls {
-	ThreeWheelOdom::ThreeWheelOdom(double center_to_right, double center_to_left, double center_to_back)
-		: centerToRight(center_to_right), centerToLeft(center_to_left), centerToBack(center_to_back) {}
+	ThreeWheelOdom::ThreeWheelOdom(double center_to_right, double center_to_left, double center_to_back, double wheel_radius)
+		: centerToRight(center_to_right), centerToLeft(center_to_left), centerToBack(center_to_back), wheelRadius(wheel_radius) {}
 
     ThreeWheelOdom::ThreeWheelOdom(double center_to_right, double center_to_left, double center_to_back, TrackingWheel &r, TrackingWheel &l, TrackingWheel &b)
 		: centerToRight(center_to_right), centerToLeft(center_to_left), centerToBack(center_to_back)
@@ -116,53 +150,66 @@ namespace ls {
 		deltaL = 0;
 		deltaR = 0;
     }
-	void ThreeWheelOdom::initialize(std::initializer_list<uint8_t> ports)
+	void ThreeWheelOdom::initialize(std::initializer_list<int8_t> ports)
     {
 		if (ports.size() != 3) {
 			throw std::invalid_argument("initializer list must only have 3 elements (right, left, back).");
 		}
+		if (wheelRadius <= 0) {
+			throw std::invalid_argument("the wheel radius must be given to the constructor to build wheels from ports.");
+		}
 		int index = 0;
-		for (uint8_t i : ports) {
-			if (abs(i) > 24) {
-				throw std::invalid_argument("ports must be in between [-24, 0) U (0, 24].");
+		for (int8_t i : ports) {
+			if (!isSmartPort(i)) {
+				throw std::invalid_argument("ports must be in between [-21, 0) U (0, 21].");
 			}
 
+			const uint8_t port = i < 0 ? -i : i;
 			if (index == 0) {
-				right = std::make_unique<TrackingWheel>(i);
+				right = std::make_unique<TrackingWheel>(port, wheelRadius, i < 0);
 			} else if (index == 1) {
-				left = std::make_unique<TrackingWheel>(i);
+				left = std::make_unique<TrackingWheel>(port, wheelRadius, i < 0);
 			} else {
-				back = std::make_unique<TrackingWheel>(i);
+				back = std::make_unique<TrackingWheel>(port, wheelRadius, i < 0);
 			}
+			index++;
 		}
-		
-    }
-
-	double ThreeWheelOdom::getDeltaX()
-    {
-		return 2 * sin(getDeltaAngle().convertToRadians() / 2) * ((deltaB / getDeltaAngle().convertToRadians()) + centerToBack);
-        // return 0.0 if no movement
+		sampler = nullptr;
+		ownSampler.reset();
     }
 
-    double ThreeWheelOdom::getDeltaY()
+	void ThreeWheelOdom::attach(SensorSampler &sensors)
     {
-		return 2 * sin(getDeltaAngle().convertToRadians() / 2) * ((deltaR / getDeltaAngle().convertToRadians()) + centerToRight);
-        // return 0.0 if no movement
-    }
-
-    Angle ThreeWheelOdom::getDeltaAngle()
-    {
-		double angleRadian = (deltaL - deltaR) / (centerToRight + centerToLeft);
-		double angleDegrees = angleRadian * 57.2958; // convert to degrees
-        return Angle(angleDegrees);
+		if (right == nullptr || left == nullptr || back == nullptr) {
+			throw std::bad_function_call();
+		}
+		rightSensor = sensors.addWheel(*right);
+		leftSensor = sensors.addWheel(*left);
+		backSensor = sensors.addWheel(*back);
+		sampler = &sensors;
+		primed = false;
     }
 
-    void ThreeWheelOdom::compute()
+    void ThreeWheelOdom::compute(const SensorFrame &frame)
     {
-		deltaL = left.get()->getLinearDeltaDistance();
-		deltaR = right.get()->getLinearDeltaDistance();
-		deltaB = back.get()->getLinearDeltaDistance();
-		AbstractOdom::compute();
+		using N = Numeric<OdomScalar>;
+		const double l = frame.distances[leftSensor];
+		const double r = frame.distances[rightSensor];
+		const double b = frame.distances[backSensor];
+		if (!primed) {
+			prevL = l;
+			prevR = r;
+			prevB = b;
+			primed = true;
+		}
+		deltaL = l - prevL;
+		deltaR = r - prevR;
+		deltaB = b - prevB;
+		prevL = l;
+		prevR = r;
+		prevB = b;
+		integrate(threeWheelTwist<OdomScalar>(N::from(deltaL), N::from(deltaR), N::from(deltaB),
+			N::from(centerToLeft), N::from(centerToRight), N::from(centerToBack)));
     }
 	
 };
@@ -172,8 +219,8 @@ namespace ls {
  * 
  */
 namespace ls {
-	ImuOdom::ImuOdom(double center_to_horiz, double center_to_vert)
-		: centerToHoriz(center_to_horiz), centerToVert(center_to_vert) {}
+	ImuOdom::ImuOdom(double center_to_horiz, double center_to_vert, double wheel_radius)
+		: centerToHoriz(center_to_horiz), centerToVert(center_to_vert), wheelRadius(wheel_radius) {}
 
     ImuOdom::ImuOdom(double center_to_horiz, double center_to_vert, TrackingWheel &h, TrackingWheel &v, pros::Imu &i)
 		: centerToHoriz(center_to_horiz), centerToVert(center_to_vert)
@@ -186,51 +233,66 @@ namespace ls {
 		prevRotation = 0;
     }
 
-	void ImuOdom::initialize(std::initializer_list<uint8_t> ports)
+	void ImuOdom::initialize(std::initializer_list<int8_t> ports)
     {
 		if (ports.size() != 3) {
 			throw std::invalid_argument("initializer list must only have 3 elements (horiz, vert, IMU).");
 		}
+		if (wheelRadius <= 0) {
+			throw std::invalid_argument("the wheel radius must be given to the constructor to build wheels from ports.");
+		}
 		int index = 0;
-		for (uint8_t i : ports) {
-			if (abs(i) > 24) {
-				throw std::invalid_argument("ports must be in between [-24, 0) U (0, 24].");
+		for (int8_t i : ports) {
+			if (!isSmartPort(i)) {
+				throw std::invalid_argument("ports must be in between [-21, 0) U (0, 21].");
 			}
 
+			const uint8_t port = i < 0 ? -i : i;
 			if (index == 0) {
-				horiz = std::make_unique<TrackingWheel>(i);
+				horiz = std::make_unique<TrackingWheel>(port, wheelRadius, i < 0);
 			} else if (index == 1) {
-				vert = std::make_unique<TrackingWheel>(i);
+				vert = std::make_unique<TrackingWheel>(port, wheelRadius, i < 0);
 			} else {
-				IMU = std::make_unique<pros::Imu>(i);
+				IMU = std::make_unique<pros::Imu>(port); // an IMU has no direction, the sign is ignored.
 			}
-		}	
-    } 
-
-	double ImuOdom::getDeltaX()
-    {
-    	return 2 * sin(getDeltaAngle().convertToRadians() / 2) * ((deltaH / getDeltaAngle().convertToRadians()) + centerToHoriz);
+			index++;
+		}
+		sampler = nullptr;
+		ownSampler.reset();
     }
 
-    double ImuOdom::getDeltaY()
+	void ImuOdom::attach(SensorSampler &sensors)
     {
-		return 2 * sin(getDeltaAngle().convertToRadians() / 2) * ((deltaV / getDeltaAngle().convertToRadians()) + centerToVert);
+		if (horiz == nullptr || vert == nullptr || IMU == nullptr) {
+			throw std::bad_function_call();
+		}
+		horizSensor = sensors.addWheel(*horiz);
+		vertSensor = sensors.addWheel(*vert);
+		imuSensor = sensors.addImu(*IMU);
+		sampler = &sensors;
+		primed = false;
     }
 
-    Angle ImuOdom::getDeltaAngle()
+    void ImuOdom::compute(const SensorFrame &frame)
     {
-		double curRotation = IMU.get()->get_rotation();
-		double deltaRotation = curRotation - prevRotation;
-		Angle angleDegrees = Angle(deltaRotation) ; // convert to Angle
+		using N = Numeric<OdomScalar>;
+		const double h = frame.distances[horizSensor];
+		const double v = frame.distances[vertSensor];
+		const double curRotation = frame.rotations[imuSensor];
+		if (!primed) {
+			prevH = h;
+			prevV = v;
+			prevRotation = curRotation;
+			primed = true;
+		}
+		deltaH = h - prevH;
+		deltaV = v - prevV;
+		prevH = h;
+		prevV = v;
+		const double deltaRotation = degreesToRadians(curRotation - prevRotation);
 		prevRotation = curRotation;
-        return Angle(deltaRotation);
-    }
-
-    void ImuOdom::compute()
-    {
-		deltaH = horiz.get()->getLinearDeltaDistance();
-		deltaV = vert.get()->getLinearDeltaDistance();
-		AbstractOdom::compute();
+		integrate(arcTwist<OdomScalar>(N::from(deltaRotation), N::from(deltaH), N::from(deltaV),
+			N::from(centerToHoriz), N::from(centerToVert)));
     }
 	
 };
\ No newline at end of file
@@ -3,7 +3,8 @@
 #include <stdexcept> 
 
 namespace ls {
-    PID::PID(float kP, float kI, float kD, float windupRange, bool signFlipReset)
+    template<typename T>
+    BasicPID<T>::BasicPID(T kP, T kI, T kD, T windupRange, bool signFlipReset)
         : kP(kP),
         kI(kI),
         kD(kD),
@@ -12,34 +13,42 @@ namespace ls {
         integral(0),
         prevError(0) {
        
-        if (kP < 0 || kI < 0 || kD < 0) {
+        if (kP < T(0) || kI < T(0) || kD < T(0)) {
             throw std::invalid_argument("PID constants must be non-negative");
         }
-        if (windupRange < 0) {
+        if (windupRange < T(0)) {
             throw std::invalid_argument("Windup range must be non-negative");
         }
     }
     
-    inline int sgn(float val) {
-        return (0 < val) - (val < 0);
+    template<typename T>
+    inline int sgn(T val) {
+        return (T(0) < val) - (val < T(0));
     }
 
-    float PID::update(const float error) {
+    template<typename T>
+    T BasicPID<T>::update(const T error) {
         
         integral += error;
         integral = std::clamp(integral, -windupRange, windupRange);
-        if (sgn(error) != sgn(prevError) && signFlipReset) integral = 0;
+        if (sgn(error) != sgn(prevError) && signFlipReset) integral = T(0);
 
         
-        const float derivative = error - prevError;
+        const T derivative = error - prevError;
         prevError = error;
 
         
         return error * kP + integral * kI + derivative * kD;
     }
 
-    void PID::reset() {
-        integral = 0;
-        prevError = 0;
+    template<typename T>
+    void BasicPID<T>::reset() {
+        integral = T(0);
+        prevError = T(0);
     }
+
+    template class BasicPID<float>;
+    template class BasicPID<double>;
+    template class BasicPID<Q16_16>;
+    template class BasicPID<Q32_32>;
 } 
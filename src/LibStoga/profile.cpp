@@ -0,0 +1,81 @@
+#include "profile.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace ls {
+    TrapezoidProfile::TrapezoidProfile(ProfileConstraints constraints, double start, double goal, double startVelocity)
+        : start(start), goal(goal), acceleration(constraints.maxAcceleration), deceleration(constraints.maxAcceleration)
+    {
+        if (constraints.maxVelocity <= 0 || constraints.maxAcceleration <= 0) {
+            throw std::invalid_argument("profile velocity and acceleration must be positive.");
+        }
+        const double distance = std::fabs(goal - start);
+        direction = goal < start ? -1 : 1;
+        // moving away from the goal is left to the feedback, the profile starts from rest then.
+        const double v0 = std::fmin(std::fmax(startVelocity * direction, 0.0), constraints.maxVelocity);
+        this->startVelocity = v0;
+
+        const double stopDistance = v0 * v0 / (2 * deceleration);
+        if (stopDistance >= distance) {
+            // too fast to stop on the goal at the limit, decelerate just hard enough.
+            peakVelocity = v0;
+            if (distance > 0 && v0 > 0) {
+                deceleration = v0 * v0 / (2 * distance);
+                decelTime = v0 / deceleration;
+            }
+            return;
+        }
+
+        const double fullDistance = (constraints.maxVelocity * constraints.maxVelocity - v0 * v0) / (2 * acceleration)
+            + constraints.maxVelocity * constraints.maxVelocity / (2 * deceleration);
+        if (fullDistance <= distance) {
+            peakVelocity = constraints.maxVelocity;
+            cruiseTime = (distance - fullDistance) / peakVelocity;
+        } else {
+            // triangle: accelerate then decelerate, meeting at the velocity that covers the distance exactly.
+            peakVelocity = std::sqrt(acceleration * distance + v0 * v0 / 2);
+        }
+        accelTime = (peakVelocity - v0) / acceleration;
+        decelTime = peakVelocity / deceleration;
+    }
+
+    ProfileState TrapezoidProfile::sample(double t) const
+    {
+        ProfileState state;
+        double traveled;
+        if (t <= 0) {
+            traveled = 0;
+            state.velocity = startVelocity;
+        } else if (t < accelTime) {
+            traveled = startVelocity * t + acceleration * t * t / 2;
+            state.velocity = startVelocity + acceleration * t;
+            state.acceleration = acceleration;
+        } else if (t < accelTime + cruiseTime) {
+            const double accelDistance = (startVelocity + peakVelocity) / 2 * accelTime;
+            traveled = accelDistance + peakVelocity * (t - accelTime);
+            state.velocity = peakVelocity;
+        } else if (t < getDuration()) {
+            const double left = getDuration() - t;
+            traveled = std::fabs(goal - start) - deceleration * left * left / 2;
+            state.velocity = deceleration * left;
+            state.acceleration = -deceleration;
+        } else {
+            state.position = goal;
+            return state;
+        }
+        state.position = start + direction * traveled;
+        state.velocity *= direction;
+        state.acceleration *= direction;
+        return state;
+    }
+
+    double TrapezoidProfile::getDuration() const
+    {
+        return accelTime + cruiseTime + decelTime;
+    }
+
+    double TrapezoidProfile::getGoal() const
+    {
+        return goal;
+    }
+}
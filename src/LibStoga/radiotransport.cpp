@@ -0,0 +1,32 @@
+#include "radiotransport.h"
+
+namespace ls {
+    RadioTransport::RadioTransport(std::uint8_t port, const char* id, bool transmitter)
+        : link(port, id, transmitter ? pros::E_LINK_TX : pros::E_LINK_RX) {}
+
+    bool RadioTransport::connected()
+    {
+        return link.connected();
+    }
+
+    std::size_t RadioTransport::send(const std::uint8_t* data, std::size_t size)
+    {
+        if (!link.connected() || link.raw_transmittable_size() < size) return 0;
+        const std::uint32_t sent = link.transmit_raw(const_cast<std::uint8_t*>(data), static_cast<std::uint16_t>(size));
+        return sent == PROS_ERR ? 0 : sent;
+    }
+
+    std::size_t RadioTransport::available()
+    {
+        const std::uint32_t size = link.raw_receivable_size();
+        return size == PROS_ERR ? 0 : size;
+    }
+
+    std::size_t RadioTransport::receive(std::uint8_t* dest, std::size_t size)
+    {
+        const std::size_t waiting = available();
+        if (waiting == 0) return 0;
+        const std::uint32_t got = link.receive_raw(dest, static_cast<std::uint16_t>(size < waiting ? size : waiting));
+        return got == PROS_ERR ? 0 : got;
+    }
+}
@@ -0,0 +1,49 @@
+#include "sensorframe.h"
+#include <stdexcept>
+
+namespace ls {
+    SensorSampler::Handle SensorSampler::addWheel(const void *wheel, WheelReader read)
+    {
+        for (std::uint8_t i = 0; i < wheelCount; i++) {
+            if (wheels[i] == wheel) return i;
+        }
+        if (wheelCount == SensorFrame::MAX_WHEELS) {
+            throw std::out_of_range("too many tracking wheels registered to one sampler.");
+        }
+        wheels[wheelCount] = wheel;
+        readers[wheelCount] = read;
+        return wheelCount++;
+    }
+
+    SensorSampler::Handle SensorSampler::addImu(pros::Imu &imu)
+    {
+        for (std::uint8_t i = 0; i < imuCount; i++) {
+            if (imus[i] == &imu) return i;
+        }
+        if (imuCount == SensorFrame::MAX_IMUS) {
+            throw std::out_of_range("too many IMUs registered to one sampler.");
+        }
+        imus[imuCount] = &imu;
+        return imuCount++;
+    }
+
+    const SensorFrame& SensorSampler::sample()
+    {
+        // Nothing else happens between the two timestamps, the reads are as close together as the ports allow.
+        frame.startTime = pros::micros();
+        for (std::uint8_t i = 0; i < wheelCount; i++) {
+            frame.distances[i] = readers[i](wheels[i]);
+        }
+        for (std::uint8_t i = 0; i < imuCount; i++) {
+            frame.rotations[i] = imus[i]->get_rotation();
+        }
+        frame.endTime = pros::micros();
+        frame.sequence++;
+        return frame;
+    }
+
+    const SensorFrame& SensorSampler::getFrame() const
+    {
+        return frame;
+    }
+}
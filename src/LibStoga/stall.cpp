@@ -0,0 +1,53 @@
+#include "stall.h"
+
+namespace ls {
+    StallDetector::StallDetector(StallConfig config)
+        : config(config) {}
+
+    StallState StallDetector::update(float volts, float rpm, float current, float dt)
+    {
+        const float absVolts = volts < 0 ? -volts : volts;
+        if (absVolts < config.minVoltage) {
+            reset();
+            return state;
+        }
+        if (state == StallState::Stalled) return state;
+
+        const std::int8_t commanded = volts > 0 ? 1 : -1;
+        if (state == StallState::Idle || commanded != direction) {
+            direction = commanded;
+            state = StallState::SpinUp;
+            timer = 0;
+        }
+        timer += dt;
+        if (state == StallState::SpinUp) {
+            if (timer < config.spinUpTime * 1e-3f) return state;
+            state = StallState::Running;
+        }
+
+        // speed along the commanded direction, negative if something is pushing it backwards.
+        const float along = rpm * direction;
+        const float expected = absVolts / 12 * config.freeSpeed;
+        const bool bogged = along < config.speedRatio * expected && current >= config.stallCurrent * absVolts / 12;
+        if (!bogged) {
+            state = StallState::Running;
+        } else if (state == StallState::Running) {
+            state = StallState::Suspect;
+            timer = dt;
+        }
+        if (state == StallState::Suspect && timer >= config.stallTime * 1e-3f) state = StallState::Stalled;
+        return state;
+    }
+
+    StallState StallDetector::getState() const
+    {
+        return state;
+    }
+
+    void StallDetector::reset()
+    {
+        state = StallState::Idle;
+        timer = 0;
+        direction = 0;
+    }
+}
@@ -0,0 +1,102 @@
+#include "velocity.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace ls {
+    VelocityEstimator::VelocityEstimator(std::size_t window)
+        : window(window)
+    {
+        if (window < 3 || window > MAX_WINDOW) {
+            throw std::invalid_argument("velocity window must be in between [3, 16].");
+        }
+    }
+
+    void VelocityEstimator::update(double pos, std::uint64_t timestamp)
+    {
+        // Slots [0, count) are filled, the first sample goes in slot 0.
+        if (count == 0) {
+            count = 1;
+        } else if (timestamp != times[newest]) {
+            newest = (newest + 1) % window;
+            if (count < window) count++;
+        }
+        positions[newest] = pos;
+        times[newest] = timestamp;
+        fit();
+    }
+
+    void VelocityEstimator::fit()
+    {
+        // Times and positions are taken relative to the newest sample: keeps the sums small
+        // (no precision lost to large timestamps) and puts the point we evaluate at t = 0.
+        const double y0 = positions[newest];
+        const std::uint64_t t0 = times[newest];
+        double s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+        double r0 = 0, r1 = 0, r2 = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            const double t = -static_cast<double>(t0 - times[i]) * 1e-6; // in seconds, <= 0
+            const double y = positions[i] - y0;
+            const double t2 = t * t;
+            s1 += t;
+            s2 += t2;
+            s3 += t2 * t;
+            s4 += t2 * t2;
+            r0 += y;
+            r1 += t * y;
+            r2 += t2 * y;
+        }
+        const double s0 = static_cast<double>(count);
+
+        if (count >= 3) {
+            // Normal equations for y = c0 + c1*t + c2*t^2, solved with Cramer's rule.
+            const double m00 = s2 * s4 - s3 * s3;
+            const double m01 = s1 * s4 - s3 * s2;
+            const double m02 = s1 * s3 - s2 * s2;
+            const double det = s0 * m00 - s1 * m01 + s2 * m02;
+            if (std::fabs(det) > 1e-30) {
+                const double c0 = (r0 * m00 - s1 * (r1 * s4 - s3 * r2) + s2 * (r1 * s3 - s2 * r2)) / det;
+                const double c1 = (s0 * (r1 * s4 - s3 * r2) - r0 * m01 + s2 * (s1 * r2 - r1 * s2)) / det;
+                const double c2 = (s0 * (s2 * r2 - r1 * s3) - s1 * (s1 * r2 - r1 * s2) + r0 * m02) / det;
+                position = y0 + c0;
+                velocity = c1;
+                acceleration = 2 * c2;
+                return;
+            }
+        }
+
+        // Not enough spread for a quadratic, fall back to a straight line.
+        position = y0;
+        acceleration = 0;
+        const double denom = s0 * s2 - s1 * s1;
+        velocity = denom > 0 ? (s0 * r1 - s1 * r0) / denom : 0;
+    }
+
+    double VelocityEstimator::getPosition() const
+    {
+        return position;
+    }
+
+    double VelocityEstimator::getVelocity() const
+    {
+        return velocity;
+    }
+
+    double VelocityEstimator::getAcceleration() const
+    {
+        return acceleration;
+    }
+
+    std::size_t VelocityEstimator::getSampleCount() const
+    {
+        return count;
+    }
+
+    void VelocityEstimator::reset()
+    {
+        newest = 0;
+        count = 0;
+        position = 0;
+        velocity = 0;
+        acceleration = 0;
+    }
+}
@@ -0,0 +1,135 @@
+#include "arm.h"
+#include <cmath>
+#include <mutex>
+#include "LibStoga/geometry.h"
+
+namespace {
+    constexpr float MAX_VOLTS = 12;
+}
+
+Arm::Arm(const RobotConfig &config, ArmSettings settings)
+    : motors(ls::usedPorts(config.armPorts)), sensor(config.armSensor), restAngle(config.armRestAngle),
+      settings(settings), pid(settings.kP, settings.kI, settings.kD, 5, true),
+      profile(settings.constraints, config.armRestAngle, config.armRestAngle), angle(config.armRestAngle) {}
+
+Arm::~Arm()
+{
+    stop();
+}
+
+void Arm::initialize()
+{
+    motors.set_brake_mode_all(pros::v5::MotorBrake::hold);
+    sensor.set_data_rate(5); // a fresh reading every update
+    sensor.reset_position();
+    angle = restAngle;
+}
+
+void Arm::start()
+{
+    if (running) return;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        profile = ls::TrapezoidProfile(settings.constraints, angle, angle);
+        moveStart = pros::millis();
+        pid.reset();
+    }
+    running = true;
+    // above the control loop, so the updates stay evenly spaced.
+    task = std::make_unique<pros::Task>([this]() {
+        std::uint32_t now = pros::millis();
+        while (running) {
+            update(now);
+            pros::Task::delay_until(&now, settings.period);
+        }
+    }, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "arm");
+}
+
+void Arm::stop()
+{
+    if (!running) return;
+    running = false;
+    task->join();
+    task.reset();
+    motors.move_voltage(0);
+}
+
+void Arm::update(std::uint32_t now)
+{
+    const std::int32_t position = sensor.get_position();
+    if (position == PROS_ERR) {
+        motors.move_voltage(0); // no sensor, don't drive the arm blind
+        return;
+    }
+    const float current = restAngle + position / 100.0f; // centidegrees
+    const float velocity = sensor.get_velocity() / 100.0f;
+    angle = current;
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    const double t = (now - moveStart) / 1000.0;
+    const ls::ProfileState reference = profile.sample(t);
+    float volts = static_cast<float>(settings.feedforward.calculate(reference.position * ls::DEG_TO_RAD, reference.velocity, reference.acceleration));
+    volts += pid.update(static_cast<float>(reference.position) - current);
+    if (volts > MAX_VOLTS) volts = MAX_VOLTS;
+    if (volts < -MAX_VOLTS) volts = -MAX_VOLTS;
+    motors.move_voltage(static_cast<std::int32_t>(volts * 1000));
+
+    if (settled) return;
+    const bool inside = t >= profile.getDuration() && std::fabs(profile.getGoal() - current) <= settings.tolerance
+        && std::fabs(velocity) <= settings.velocityTolerance;
+    if (!inside) {
+        settleSince = 0;
+    } else if (settleSince == 0) {
+        settleSince = now;
+    } else if (now - settleSince >= settings.settleTime) {
+        settleDuration = settleSince - moveStart;
+        settled = true;
+    }
+}
+
+void Arm::moveTo(float degrees)
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    const std::uint32_t now = pros::millis();
+    // start from where the last move wants the arm right now, so a new goal mid-move has no jump.
+    const ls::ProfileState from = profile.sample((now - moveStart) / 1000.0);
+    profile = ls::TrapezoidProfile(settings.constraints, from.position, degrees, from.velocity);
+    moveStart = now;
+    settleSince = 0;
+    settled = false;
+}
+
+void Arm::moveTo(ArmPreset preset)
+{
+    switch (preset) {
+        case ArmPreset::Load: moveTo(settings.loadAngle); break;
+        case ArmPreset::Hold: moveTo(settings.holdAngle); break;
+        case ArmPreset::Score: moveTo(settings.scoreAngle); break;
+    }
+}
+
+float Arm::getAngle() const
+{
+    return angle;
+}
+
+float Arm::getTarget()
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return static_cast<float>(profile.getGoal());
+}
+
+bool Arm::isSettled() const
+{
+    return settled;
+}
+
+std::uint32_t Arm::getSettleTime() const
+{
+    return settleDuration;
+}
+
+ls::Command Arm::waitSettled(std::uint32_t timeout)
+{
+    co_await ls::until([this]() { return isSettled(); }, timeout);
+}
@@ -0,0 +1,50 @@
+#include "autons.h"
+#include <cmath>
+#include "characterize.h"
+
+namespace {
+    constexpr std::uint32_t YIELD_TIMEOUT = 3000; // in ms, a partner that never clears can't hold up the routine for good
+
+    /**
+     * Sends the partner where a straight drive of 'distance' inches ends, and waits while the link says to let it pass.
+     * The link is updated from the scheduler tick hook, so it decides with the new target on the next tick.
+     */
+    ls::Command waitForRightOfWay(double distance)
+    {
+        const ls::Position pos = drivetrain.odom->getPosition();
+        const double heading = pos.theta.convertToRadians();
+        allianceLink.setTarget(pos.X + distance * std::sin(heading), pos.Y + distance * std::cos(heading));
+        co_await ls::nextTick();
+        co_await ls::until([]() { return !allianceLink.shouldYield(); }, YIELD_TIMEOUT);
+    }
+}
+
+ls::Command autonDoNothing()
+{
+    co_return;
+}
+
+ls::Command autonLeaveLine()
+{
+    co_await waitForRightOfWay(24);
+    co_await ls::drive(drivetrain, 24, 2000);
+    allianceLink.clearTarget();
+}
+
+ls::Command autonCharacterize()
+{
+    co_await characterizeDrive(chassis, linearFF, angularFF);
+}
+
+ls::Command autonClampGoal()
+{
+    clamp.arm();
+    co_await waitForRightOfWay(-36);
+    // backs into the goal and stops the moment it is clamped, instead of driving a fixed distance and waiting.
+    co_await ls::race(ls::drive(drivetrain, -36, 2500), clamp.waitClamped());
+    allianceLink.clearTarget();
+    if (!clamp.isClamped()) co_return;
+    intake.move(12);
+    co_await ls::wait(1500);
+    intake.stop();
+}
@@ -0,0 +1,137 @@
+#include "characterize.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include "LibStoga/velocity.h"
+#include "settings.h"
+
+namespace {
+    constexpr std::size_t MAX_SAMPLES = 4096; // ~40s of 10ms ticks, more than all the runs take
+    constexpr double MIN_LINEAR_SPEED = 0.5; // in in/s, slower samples are mostly static friction
+    constexpr double MIN_ANGULAR_SPEED = 0.05; // in rad/s
+
+    struct Phase {
+        const char* name;
+        bool angular;
+        bool quasistatic;
+        double direction;
+    };
+
+    constexpr Phase PHASES[] = {
+        {"linear quasistatic forward", false, true, 1},
+        {"linear quasistatic backward", false, true, -1},
+        {"linear dynamic forward", false, false, 1},
+        {"linear dynamic backward", false, false, -1},
+        {"angular quasistatic right", true, true, 1},
+        {"angular quasistatic left", true, true, -1},
+        {"angular dynamic right", true, false, 1},
+        {"angular dynamic left", true, false, -1},
+    };
+
+    struct Sample {
+        std::uint32_t time; // in ms
+        std::uint8_t phase;
+        float voltage;
+        float velocity;
+        float acceleration;
+    };
+
+    // Kept out of the coroutine frame, which comes from the fixed command arena.
+    Sample samples[MAX_SAMPLES];
+    std::size_t sampleCount = 0;
+
+    struct StopGuard {
+        Chassis& chassis;
+        ~StopGuard() { chassis.stopAllMotors(); }
+    };
+
+    ls::Command runPhase(Chassis& chassis, std::uint8_t index, const CharacterizeSettings& settings, ls::FeedforwardFit& fit)
+    {
+        const Phase& phase = PHASES[index];
+        const std::uint32_t timeout = phase.quasistatic ? settings.quasistaticTime : settings.dynamicTime;
+        const double limit = phase.angular ? settings.maxRotation : settings.maxDistance;
+        const DriveSide leftStart = chassis.getLeftState();
+        const DriveSide rightStart = chassis.getRightState();
+        ls::VelocityEstimator estimator;
+        const std::uint32_t startTime = pros::millis();
+
+        while (pros::millis() - startTime < timeout) {
+            const double elapsed = (pros::millis() - startTime) / 1000.0;
+            const double volts = phase.direction * std::min(12.0, phase.quasistatic ? settings.rampRate * elapsed : settings.stepVoltage);
+            chassis.moveVoltage(volts, phase.angular ? -volts : volts);
+            co_await ls::nextTick();
+
+            // the state cache is refreshed at the start of every tick, so this is what the last voltage did.
+            const DriveSide left = chassis.getLeftState();
+            const DriveSide right = chassis.getRightState();
+            const double leftTravel = left.position - leftStart.position;
+            const double rightTravel = right.position - rightStart.position;
+            // turning uses the difference of the sides, bearings turn clockwise so turning right is positive.
+            const double position = phase.angular ? (leftTravel - rightTravel) / chassis.getConfig().wheelTrack : (leftTravel + rightTravel) / 2;
+            const double voltage = phase.angular ? (left.voltage - right.voltage) / 2 : (left.voltage + right.voltage) / 2;
+            estimator.update(position, pros::micros());
+
+            if (estimator.getSampleCount() >= 3) {
+                fit.add(voltage, estimator.getVelocity(), estimator.getAcceleration());
+                if (sampleCount < MAX_SAMPLES) {
+                    samples[sampleCount++] = {pros::millis(), index, static_cast<float>(voltage),
+                        static_cast<float>(estimator.getVelocity()), static_cast<float>(estimator.getAcceleration())};
+                }
+            }
+            if (std::fabs(position) > limit) break;
+        }
+        chassis.stopAllMotors();
+        co_await ls::wait(settings.restTime);
+    }
+
+    void writeLog(const char* path)
+    {
+        std::FILE* file = std::fopen(path, "w");
+        if (file == nullptr) {
+            std::cout << "characterize: could not open " << path << std::endl;
+            return;
+        }
+        std::fprintf(file, "time,phase,voltage,velocity,acceleration\n");
+        for (std::size_t i = 0; i < sampleCount; i++) {
+            const Sample& s = samples[i];
+            std::fprintf(file, "%lu,%s,%.4f,%.4f,%.4f\n", static_cast<unsigned long>(s.time), PHASES[s.phase].name,
+                s.voltage, s.velocity, s.acceleration);
+        }
+        std::fclose(file);
+    }
+
+    void report(const char* name, const ls::FeedforwardFit& fit, const ls::FeedforwardGains& gains)
+    {
+        std::cout << "characterize " << name << ": kS " << gains.kS << " kV " << gains.kV << " kA " << gains.kA
+            << " (r^2 " << fit.getRSquared() << ", " << fit.getCount() << " samples)" << std::endl;
+    }
+}
+
+ls::Command characterizeDrive(Chassis &chassis, ls::FeedforwardGains &linear, ls::FeedforwardGains &angular, CharacterizeSettings settings)
+{
+    StopGuard guard{chassis};
+    ls::FeedforwardFit linearFit(MIN_LINEAR_SPEED);
+    ls::FeedforwardFit angularFit(MIN_ANGULAR_SPEED);
+    sampleCount = 0;
+
+    for (std::uint8_t i = 0; i < std::size(PHASES); i++) {
+        co_await runPhase(chassis, i, settings, PHASES[i].angular ? angularFit : linearFit);
+    }
+
+    writeLog(CHARACTERIZE_LOG_FILE);
+    const ls::FeedforwardGains linearGains = linearFit.solve();
+    const ls::FeedforwardGains angularGains = angularFit.solve();
+    report("linear", linearFit, linearGains);
+    report("angular", angularFit, angularGains);
+    if (linearGains.kV <= 0 || angularGains.kV <= 0) {
+        std::cout << "characterize: fit failed, keeping the old gains" << std::endl;
+        co_return;
+    }
+    linear = linearGains;
+    angular = angularGains;
+    if (!ls::saveFeedforward(FEEDFORWARD_FILE, linear, angular)) {
+        std::cout << "characterize: could not write " << FEEDFORWARD_FILE << std::endl;
+    }
+}
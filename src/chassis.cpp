@@ -1,35 +1,191 @@
-// #include "chassis.h"
-// #include "settings.h"
-// #include "api.h"
+#include "chassis.h"
 
-// Chassis::Chassis(): is_auton(false) {}
+namespace {
+    constexpr float MAX_MILLIVOLTS = 12000;
+    constexpr float MAX_OUTPUT_DT = 0.05f; // in seconds, caps the slew step after a pause in output
+}
 
-// void Chassis::initialize()
-// {
-//     left = new pros::MotorGroup(LEFT_PORTS);
-//     right = new pros::MotorGroup(RIGHT_PORTS);
-// }
+Chassis::Chassis(ls::MotorCommandBuffer &commands, const RobotConfig &config)
+    : config(config),
+      geometry(driveGeometry(config)),
+      left(ls::usedPorts(config.leftPorts)), right(ls::usedPorts(config.rightPorts)),
+      commands(commands), leftHandle(commands.add(left)), rightHandle(commands.add(right)),
+      throttleCurve(ls::CurveType::Cubic, 0.5f, 5),
+      turnCurve(ls::CurveType::Cubic, 0.7f, 5) {}
 
-// void Chassis::stopAllMotors()
-// {
-//     left->brake();
-//     right->brake();
-// }
+void Chassis::initialize()
+{
+    commands.setBrakeMode(leftHandle, pros::v5::MotorBrake::coast);
+    commands.setBrakeMode(rightHandle, pros::v5::MotorBrake::coast);
+}
 
-// void Chassis::op_move(std::int32_t X, std::int32_t Y)
-// {
-// }
+void Chassis::stopAllMotors()
+{
+    commands.brake(leftHandle);
+    commands.brake(rightHandle);
+    leftSlew.reset();
+    rightSlew.reset();
+    leftTraction.reset();
+    rightTraction.reset();
+}
 
-// Chassis::~Chassis()
-// {
-//     delete left;
-//     delete right;
-// }
+void Chassis::setCurves(const ls::JoystickCurve &throttle, const ls::JoystickCurve &turn)
+{
+    throttleCurve = throttle;
+    turnCurve = turn;
+}
 
+void Chassis::setCurvature(float sensitivity, float quickTurn)
+{
+    turnSensitivity = sensitivity;
+    quickTurnThreshold = quickTurn;
+}
 
+void Chassis::setSlew(float accelRate, float decelRate)
+{
+    leftSlew = ls::SlewLimiter(accelRate, decelRate);
+    rightSlew = ls::SlewLimiter(accelRate, decelRate);
+}
 
+void Chassis::setTraction(const ls::TractionConfig &config)
+{
+    leftTraction = ls::TractionControl(config);
+    rightTraction = ls::TractionControl(config);
+}
 
+void Chassis::attach(ls::MotorStateCache &cache)
+{
+    states = &cache;
+    leftState = cache.add(left);
+    rightState = cache.add(right);
+}
 
+void Chassis::attach(ls::MotorMonitor &monitor)
+{
+    this->monitor = &monitor;
+    leftHealth = monitor.add(left);
+    rightHealth = monitor.add(right);
+}
 
+DriveSide Chassis::readSide(ls::MotorStateCache::Handle first, std::int8_t size) const
+{
+    const ls::MotorStates &s = states->getStates();
+    DriveSide side;
+    for (std::int8_t i = 0; i < size; i++) {
+        side.position += s.position[first + i];
+        side.speed += s.velocity[first + i];
+        side.current += s.current[first + i];
+        side.voltage += s.voltage[first + i];
+    }
+    side.position *= geometry.inchesPerDegree / size;
+    side.speed *= geometry.inchesPerRpm / size;
+    side.current /= size;
+    side.voltage /= 1000.0f * size;
+    return side;
+}
 
+void Chassis::updateTraction(ls::AbstractOdom &odom, double dt)
+{
+    if (states == nullptr || dt <= 0) return;
+    const ls::Twist2<double> delta = odom.getLocalDelta();
+    const float forward = delta.dx / dt;
+    // bearings turn clockwise, so turning right (positive) speeds up the left side.
+    const float turn = delta.dtheta / dt * geometry.halfTrack;
 
+    const DriveSide leftSide = readSide(leftState, left.size());
+    leftTraction.update(leftSide.speed, forward + turn, leftSide.current);
+    const DriveSide rightSide = readSide(rightState, right.size());
+    rightTraction.update(rightSide.speed, forward - turn, rightSide.current);
+}
+
+void Chassis::output(float leftPower, float rightPower)
+{
+    ls::desaturate(leftPower, rightPower);
+
+    const std::uint64_t now = pros::micros();
+    float dt = lastOutput == 0 ? MAX_OUTPUT_DT : (now - lastOutput) * 1e-6f;
+    if (dt > MAX_OUTPUT_DT) dt = MAX_OUTPUT_DT;
+    lastOutput = now;
+    leftPower = leftTraction.apply(leftSlew.update(leftPower, dt));
+    rightPower = rightTraction.apply(rightSlew.update(rightPower, dt));
+    if (monitor != nullptr) {
+        leftPower *= monitor->getPowerScale(leftHealth, left.size());
+        rightPower *= monitor->getPowerScale(rightHealth, right.size());
+    }
+
+    commands.setVoltage(leftHandle, static_cast<std::int32_t>(leftPower * MAX_MILLIVOLTS));
+    commands.setVoltage(rightHandle, static_cast<std::int32_t>(rightPower * MAX_MILLIVOLTS));
+}
+
+void Chassis::tank(std::int32_t leftY, std::int32_t rightY)
+{
+    output(throttleCurve(leftY), throttleCurve(rightY));
+}
+
+void Chassis::arcade(std::int32_t throttle, std::int32_t turn)
+{
+    const float forward = throttleCurve(throttle);
+    const float rotate = turnCurve(turn);
+    output(forward + rotate, forward - rotate);
+}
+
+void Chassis::curvature(std::int32_t throttle, std::int32_t turn, bool quickTurn)
+{
+    const float forward = throttleCurve(throttle);
+    const float rotate = turnCurve(turn);
+    const float absForward = forward < 0 ? -forward : forward;
+    if (quickTurn || absForward < quickTurnThreshold) {
+        output(forward + rotate, forward - rotate);
+        return;
+    }
+    // Turn rate scales with speed, which keeps the radius of the turn constant.
+    const float angular = absForward * rotate * turnSensitivity;
+    output(forward + angular, forward - angular);
+}
+
+void Chassis::op_move(std::int32_t X, std::int32_t Y)
+{
+    curvature(Y, X);
+}
+
+void Chassis::move(double leftPower, double rightPower)
+{
+    output(static_cast<float>(leftPower / 127), static_cast<float>(rightPower / 127));
+}
+
+void Chassis::moveVoltage(double leftVolts, double rightVolts)
+{
+    // keep the slew limiters where the output is, so going back to normal driving does not jump.
+    leftSlew.reset(static_cast<float>(leftVolts * 1000 / MAX_MILLIVOLTS));
+    rightSlew.reset(static_cast<float>(rightVolts * 1000 / MAX_MILLIVOLTS));
+    lastOutput = pros::micros();
+    commands.setVoltage(leftHandle, static_cast<std::int32_t>(leftVolts * 1000));
+    commands.setVoltage(rightHandle, static_cast<std::int32_t>(rightVolts * 1000));
+}
+
+DriveSide Chassis::getLeftState() const
+{
+    if (states == nullptr) return {};
+    return readSide(leftState, left.size());
+}
+
+DriveSide Chassis::getRightState() const
+{
+    if (states == nullptr) return {};
+    return readSide(rightState, right.size());
+}
+
+const RobotConfig& Chassis::getConfig() const
+{
+    return config;
+}
+
+pros::MotorGroup& Chassis::getLeft()
+{
+    return left;
+}
+
+pros::MotorGroup& Chassis::getRight()
+{
+    return right;
+}
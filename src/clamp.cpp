@@ -0,0 +1,125 @@
+#include "clamp.h"
+#include <mutex>
+
+Clamp::Clamp(char piston, std::int8_t distancePort, ClampSettings settings)
+    : piston(piston, false), distance(std::make_unique<pros::Distance>(distancePort)), settings(settings) {}
+
+Clamp::Clamp(char piston, char limitSwitch, ClampSettings settings)
+    : piston(piston, false), limitSwitch(std::make_unique<pros::adi::DigitalIn>(limitSwitch)), settings(settings) {}
+
+Clamp::~Clamp()
+{
+    stop();
+}
+
+void Clamp::start()
+{
+    if (running) return;
+    running = true;
+    // above the control loop, so the clamp closes the moment the goal is seated instead of after it.
+    task = std::make_unique<pros::Task>([this]() { loop(); }, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "clamp");
+}
+
+void Clamp::stop()
+{
+    if (!running) return;
+    running = false;
+    task->join();
+    task.reset();
+}
+
+bool Clamp::readSeated()
+{
+    if (distance) {
+        const std::int32_t mm = distance->get_distance();
+        return mm != PROS_ERR && mm <= settings.seatDistance;
+    }
+    return limitSwitch->get_value() == 1;
+}
+
+void Clamp::loop()
+{
+    std::uint32_t now = pros::millis();
+    while (running) {
+        const bool seated = readSeated();
+        {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            if (rearm && !seated) {
+                rearm = false;
+                state = ClampState::Armed;
+            }
+            seatedCount = seated && state == ClampState::Armed ? seatedCount + 1 : 0;
+            if (seatedCount >= settings.confirmSamples) {
+                piston.extend();
+                state = ClampState::Clamped;
+                clampedAt = pros::millis();
+                clamps++;
+                seatedCount = 0;
+            }
+        }
+        pros::Task::delay_until(&now, settings.pollPeriod);
+    }
+}
+
+void Clamp::arm()
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    piston.retract();
+    rearm = false;
+    seatedCount = 0;
+    state = ClampState::Armed;
+}
+
+void Clamp::close()
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (state == ClampState::Clamped) return;
+    piston.extend();
+    rearm = false;
+    state = ClampState::Clamped;
+    clampedAt = pros::millis();
+    clamps++;
+}
+
+void Clamp::release()
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    piston.retract();
+    rearm = true;
+    seatedCount = 0;
+    state = ClampState::Open;
+}
+
+void Clamp::disarm()
+{
+    std::lock_guard<pros::Mutex> lock(mutex);
+    piston.retract();
+    rearm = false;
+    seatedCount = 0;
+    state = ClampState::Open;
+}
+
+ClampState Clamp::getState() const
+{
+    return state;
+}
+
+bool Clamp::isClamped() const
+{
+    return state == ClampState::Clamped;
+}
+
+std::uint32_t Clamp::getClampedAt() const
+{
+    return clampedAt;
+}
+
+std::uint32_t Clamp::getClamps() const
+{
+    return clamps;
+}
+
+ls::Command Clamp::waitClamped(std::uint32_t timeout)
+{
+    co_await ls::until([this]() { return isClamped(); }, timeout);
+}
@@ -0,0 +1,115 @@
+#include "intake.h"
+#include <stdexcept>
+
+Intake::Intake(ls::MotorCommandBuffer &commands, const RobotConfig &config, ls::StallConfig stall)
+    : motors(ls::usedPorts(config.intakePorts)),
+      commands(commands), handle(commands.add(motors)),
+      stall(stall) {}
+
+void Intake::initialize()
+{
+    commands.setBrakeMode(handle, pros::v5::MotorBrake::coast);
+}
+
+void Intake::attach(ls::MotorStateCache &cache)
+{
+    states = &cache;
+    stateHandle = cache.add(motors);
+}
+
+void Intake::attach(ls::MotorMonitor &monitor)
+{
+    this->monitor = &monitor;
+    healthHandle = monitor.add(motors);
+}
+
+void Intake::setUnjam(float volts, std::uint32_t time)
+{
+    if (volts <= 0 || volts > 12) {
+        throw std::invalid_argument("unjam voltage must be in between (0, 12].");
+    }
+    reverseVolts = volts;
+    reverseTime = time * 1e-3f;
+}
+
+void Intake::move(float volts)
+{
+    wanted = volts;
+}
+
+void Intake::stop()
+{
+    wanted = 0;
+}
+
+bool Intake::checkStall(float volts, float dt)
+{
+    if (states == nullptr) return false;
+    const ls::MotorStates &s = states->getStates();
+    const std::int8_t size = motors.size();
+    float rpm = 0;
+    float current = 0;
+    for (std::int8_t i = 0; i < size; i++) {
+        if (!s.valid[stateHandle + i]) return false;
+        rpm += s.velocity[stateHandle + i];
+        current += s.current[stateHandle + i];
+    }
+    return stall.update(volts, rpm / size, current / size, dt) == ls::StallState::Stalled;
+}
+
+void Intake::update(float dt)
+{
+    if (wanted == 0) {
+        state = IntakeState::Stopped;
+        unjamLeft = 0;
+        stall.reset();
+        commands.setVoltage(handle, 0);
+        return;
+    }
+
+    // the stall detector expects the speed of the derated voltage, not of the one asked for.
+    const float scale = monitor != nullptr ? monitor->getPowerScale(healthHandle, motors.size()) : 1;
+    if (unjamLeft <= 0) {
+        state = IntakeState::Running;
+        runTime += dt;
+        if (checkStall(wanted * scale, dt)) {
+            jams++;
+            stall.reset(); // spins up again once the unjam is over
+            unjamLeft = reverseTime;
+        }
+    }
+    if (unjamLeft > 0) {
+        state = IntakeState::Unjamming;
+        unjamLeft -= dt;
+        unjamTime += dt;
+        commands.setVoltage(handle, static_cast<std::int32_t>((wanted < 0 ? reverseVolts : -reverseVolts) * scale * 1000));
+        return;
+    }
+    commands.setVoltage(handle, static_cast<std::int32_t>(wanted * scale * 1000));
+}
+
+void Intake::countRing()
+{
+    rings++;
+}
+
+IntakeState Intake::getState() const
+{
+    return state;
+}
+
+IntakeStats Intake::getStats() const
+{
+    IntakeStats stats;
+    stats.rings = rings;
+    stats.jams = jams;
+    stats.runTime = runTime;
+    stats.unjamTime = unjamTime;
+    stats.ringsPerMinute = runTime > 0 ? stats.rings / runTime * 60 : 0;
+    return stats;
+}
+
+pros::MotorGroup& Intake::getMotors()
+{
+    return motors;
+}
@@ -2,22 +2,143 @@
 #include "LibStoga/libstoga.h"
 
 #include "settings.h"
+#include "arm.h"
+#include "autons.h"
+#include "chassis.h"
+#include "clamp.h"
+#include "intake.h"
+#include "robotconfig.h"
 
-ls::TrackingWheel right(RIGHT_TRACKING, 2.75, true);
-ls::TrackingWheel left(LEFT_TRACKING);
-ls::TrackingWheel center(CENTER_TRACKING);
+const RobotConfig& config = robotConfig(); // loads ROBOT_CONFIG_FILE, before anything below is built from it
+
+ls::TrackingWheel right(std::abs(config.rightTracking), driveGeometry(config).trackingRadius, config.rightTracking < 0);
+ls::TrackingWheel left(std::abs(config.leftTracking), driveGeometry(config).trackingRadius, config.leftTracking < 0);
+ls::TrackingWheel center(std::abs(config.centerTracking), driveGeometry(config).trackingRadius, config.centerTracking < 0);
 
 ls::ThreeWheelOdom odom(
-	PARALLEL_SENSOR_TRACK_WIDTH, 
-	PARALLEL_SENSOR_TRACK_WIDTH, 
-	MIDDLE_ENCODER_DISTANCE, 
+	config.rightTrackingOffset,
+	config.leftTrackingOffset,
+	config.centerTrackingOffset,
 	right,
 	left,
 	center
 );
 
+ls::MotorCommandBuffer motorCommands;
+Chassis chassis(motorCommands, config);
+ls::MotorMonitor monitor;
+Intake intake(motorCommands, config);
+pros::adi::Pneumatics ejector(config.ejector, false);
+ls::ColorSorter colorSort(std::abs(config.colorSensor), intake.getMotors(), config.conveyorTravel, config.ejectDistance);
+Clamp clamp(config.clamp, static_cast<std::int8_t>(std::abs(config.goalSensor)));
+Arm arm(config);
+ls::RadioTransport radio(std::abs(config.linkRadio), ALLIANCE_LINK_ID, config.linkTransmitter);
+ls::AllianceLink allianceLink(radio, {.leader = config.linkTransmitter});
+ls::MotorStateCache motorStates;
+ls::FeedforwardGains linearFF; // measured by the Characterize routine, not used by the motion code yet
+ls::FeedforwardGains angularFF;
+ls::PID linearPID(8, 0, 30, 3, true);
+ls::PID angularPID(2, 0, 10, 3, true);
+
+ls::MotionConfig drivetrain{&odom, &linearPID, &angularPID, [](double l, double r) {
+	chassis.move(l, r);
+}};
+
+ls::Input input;
+ls::ControllerDisplay display(pros::E_CONTROLLER_MASTER);
+ls::FieldView fieldView(START_X, START_Y);
+ls::SensorSampler sensors;
+ls::Scheduler scheduler;
+ls::AutonSelector selector(AUTON_ROUTINES);
+
+/**
+ * Sends this robot's state to the alliance partner and reads the partner's,
+ * once per control loop in both autonomous and opcontrol.
+ */
+void updateAllianceLink() {
+	const ls::Position pos = odom.getPosition();
+	allianceLink.setPose(pos.X, pos.Y, pos.theta.getAngle());
+	allianceLink.setFlag(ls::PartnerFlag::Clamped, clamp.isClamped());
+	allianceLink.update(pros::millis());
+}
+
+/**
+ * Gets the clamp's state for the controller screen, at most 4 characters.
+ */
+const char* clampText() {
+	switch (clamp.getState()) {
+		case ClampState::Open: return "open";
+		case ClampState::Armed: return "ARM";
+		case ClampState::Clamped: return "GOAL";
+	}
+	return "";
+}
+
 void initialize() {
-	pros::lcd::initialize();
+	chassis.initialize();
+	intake.initialize();
+	arm.initialize(); // the arm must be resting here
+	if (!ls::loadFeedforward(FEEDFORWARD_FILE, linearFF, angularFF)) {
+		std::cout << "no feedforward gains on the SD card, run the Characterize routine" << std::endl;
+	}
+	chassis.attach(monitor); // both derate their output as their motors heat up
+	intake.attach(monitor);
+	monitor.onEvent([](ls::MotorMonitor::Handle motor, ls::HealthEvent event) {
+		const ls::MotorHealth health = monitor.getHealth(motor);
+		std::cout << "motor " << static_cast<int>(motor) << " event " << static_cast<int>(event)
+			<< " temp " << health.temperature.last << "C efficiency " << health.efficiency.average << "%" << std::endl;
+		if (event == ls::HealthEvent::OverTemp) display.rumble("- -");
+	});
+	monitor.start();
+	display.start();
+	colorSort.onEject([]() { ejector.extend(); }, []() { ejector.retract(); });
+	colorSort.onRing([](ls::RingColor) { intake.countRing(); });
+	colorSort.start();
+	clamp.start();
+	arm.start();
+	input.on(ls::ControllerId::Master, ls::Button::L1, ls::ButtonEvent::Press, []() {
+		// a released goal is not grabbed again, the clamp re-arms once it is gone
+		if (clamp.isClamped()) {
+			clamp.release();
+		} else {
+			clamp.close();
+		}
+	});
+	input.on(ls::ControllerId::Master, ls::Button::Down, ls::ButtonEvent::Press, []() { arm.moveTo(ArmPreset::Load); });
+	input.on(ls::ControllerId::Master, ls::Button::Right, ls::ButtonEvent::Press, []() { arm.moveTo(ArmPreset::Hold); });
+	input.on(ls::ControllerId::Master, ls::Button::Up, ls::ButtonEvent::Press, []() { arm.moveTo(ArmPreset::Score); });
+	input.on(ls::ControllerId::Master, ls::Button::Y, ls::ButtonEvent::Press, []() {
+		// cycles off -> eject red -> eject blue
+		switch (colorSort.getEjectColor()) {
+			case ls::RingColor::None: colorSort.setEjectColor(ls::RingColor::Red); break;
+			case ls::RingColor::Red: colorSort.setEjectColor(ls::RingColor::Blue); break;
+			case ls::RingColor::Blue: colorSort.setEjectColor(ls::RingColor::None); break;
+		}
+	});
+	chassis.attach(motorStates);
+	intake.attach(motorStates); // jams are found from the same refresh as traction control
+	odom.attach(sensors);
+	allianceLink.setOrigin(START_X, START_Y, START_HEADING);
+	scheduler.addTickHook([]() {
+		motorStates.refresh();
+		odom.compute(sensors.sample());
+		chassis.updateTraction(odom, scheduler.getPeriod() / 1000.0);
+		intake.update(scheduler.getPeriod() / 1000.0f);
+		updateAllianceLink();
+	});
+	scheduler.addEndHook([]() { motorCommands.flush(); });
+	selector.select(0); // default routine is ready even if the selector never runs.
+}
+
+/**
+ * Stops the drive and the intake right away. A killed task never runs the
+ * output guards of its commands, so this is done wherever one may have been.
+ */
+void stopOutputs() {
+	chassis.stopAllMotors();
+	intake.stop();
+	intake.update(0);
+	motorCommands.flush();
 }
 
 /**
@@ -26,7 +147,9 @@ void initialize() {
  * the robot is enabled, this task will exit.
  */
 void disabled() {
-	// chassis.stopAllMotors();
+	scheduler.clear(); // frees the routine the autonomous task was killed in
+	stopOutputs();
+	fieldView.stop(); // leaves the screen to the auton selector
 }
 
 /**
@@ -38,7 +161,9 @@ void disabled() {
  * This task will exit when the robot is enabled and autonomous or opcontrol
  * starts.
  */
-void competition_initialize() {}
+void competition_initialize() {
+	selector.runSelector();
+}
 
 /**
  * Runs the user autonomous code. This function will be started in its own task
@@ -52,7 +177,18 @@ void competition_initialize() {}
  * from where it left off.
  */
 void autonomous() {
-
+	// routines written for one alliance throw out the other alliance's rings.
+	switch (selector.getSelected().color) {
+		case ls::AllianceColor::Red: colorSort.setEjectColor(ls::RingColor::Blue); break;
+		case ls::AllianceColor::Blue: colorSort.setEjectColor(ls::RingColor::Red); break;
+		case ls::AllianceColor::Any: break;
+	}
+	// a restarted task (after a disable or lost comms) must not resume the old routine next to the new one.
+	scheduler.clear();
+	stopOutputs();
+	allianceLink.setFlag(ls::PartnerFlag::Autonomous, true);
+	scheduler.run(selector.take());
+	allianceLink.setFlag(ls::PartnerFlag::Autonomous, false);
 }
 
 /**
@@ -69,32 +205,38 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
-	pros::Controller master(pros::E_CONTROLLER_MASTER);
-	pros::Motor one(1);
-	pros::Motor two(2);
-	pros::Motor three(3);
-	ls::TrackingWheel encoder('A', 'B', 2.75);
-	master.clear();
-
-	one.set_brake_mode(pros::motor_brake_mode_e::E_MOTOR_BRAKE_COAST);
-	two.set_brake_mode(pros::motor_brake_mode_e::E_MOTOR_BRAKE_COAST);
-	three.set_brake_mode(pros::motor_brake_mode_e::E_MOTOR_BRAKE_COAST);
+	display.clear();
+	fieldView.start();
+	allianceLink.setFlag(ls::PartnerFlag::Autonomous, false);
+	allianceLink.clearTarget(); // the driver's path is not known
+	std::uint32_t clamps = clamp.getClamps();
 
 	while (true) {
-		// odom.compute();
-
-		int scale = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
-		one.move(scale);
-		two.move(scale);
-		three.move(scale);
-
-		std::cout << (one.get_efficiency() + two.get_efficiency() + three.get_efficiency()) / 3.0 << std::endl;
-
-		// std::cout << encoder.getLinearDistance() << "\n";
+		motorStates.refresh();
+		odom.compute(sensors.sample());
+		chassis.updateTraction(odom, 0.02); // the loop runs every 20ms
+		fieldView.setPose(odom.getPosition()); // drawn by the field view task, not here
 
-		// other stuff.. TODO (based on robor)
+		input.update(); // every controller input is read here, once per loop
+		chassis.op_move(input.getAxis(ls::ControllerId::Master, ls::Axis::RightX), input.getAxis(ls::ControllerId::Master, ls::Axis::LeftY));
+		if (input.isDown(ls::ControllerId::Master, ls::Button::R1)) {
+			intake.move(12);
+		} else if (input.isDown(ls::ControllerId::Master, ls::Button::R2)) {
+			intake.move(-12);
+		} else {
+			intake.stop();
+		}
+		intake.update(0.02f); // unjams on its own
+		updateAllianceLink();
+		motorCommands.flush(); // only what changed since the last loop is sent
+		display.print(0, "Batt %d%%", static_cast<int>(pros::battery::get_capacity())); // sent only when it changes
+		if (clamp.getClamps() != clamps) {
+			clamps = clamp.getClamps();
+			display.rumble("."); // the clamp closes on its own when armed, the driver feels it without looking
+		}
+		display.print(1, "Eject %-4s %s", colorSort.getEjectColor() == ls::RingColor::Red ? "red" : colorSort.getEjectColor() == ls::RingColor::Blue ? "blue" : "off", clampText());
+		display.print(2, "Arm %lums", static_cast<unsigned long>(arm.getSettleTime())); // time of the last settled move
 		pros::delay(20);
-		pros::lcd::clear_line(1);
 	}
 	
 }
\ No newline at end of file
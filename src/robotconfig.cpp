@@ -0,0 +1,51 @@
+#include "robotconfig.h"
+#include <iostream>
+#include "settings.h"
+
+namespace {
+    constexpr std::array<ls::ConfigField<RobotConfig>, 24> FIELDS = {{
+        {"tracking_diameter", &RobotConfig::trackingDiameter},
+        {"right_tracking_offset", &RobotConfig::rightTrackingOffset},
+        {"left_tracking_offset", &RobotConfig::leftTrackingOffset},
+        {"center_tracking_offset", &RobotConfig::centerTrackingOffset},
+        {"wheel_diameter", &RobotConfig::wheelDiameter},
+        {"gear_ratio", &RobotConfig::gearRatio},
+        {"wheel_track", &RobotConfig::wheelTrack},
+        {"conveyor_travel", &RobotConfig::conveyorTravel},
+        {"eject_distance", &RobotConfig::ejectDistance},
+        {"arm_rest_angle", &RobotConfig::armRestAngle},
+        {"left_ports", &RobotConfig::leftPorts},
+        {"right_ports", &RobotConfig::rightPorts},
+        {"intake_ports", &RobotConfig::intakePorts},
+        {"arm_ports", &RobotConfig::armPorts},
+        {"right_tracking", &RobotConfig::rightTracking},
+        {"left_tracking", &RobotConfig::leftTracking},
+        {"center_tracking", &RobotConfig::centerTracking},
+        {"color_sensor", &RobotConfig::colorSensor},
+        {"goal_sensor", &RobotConfig::goalSensor},
+        {"arm_sensor", &RobotConfig::armSensor},
+        {"link_radio", &RobotConfig::linkRadio},
+        {"ejector", &RobotConfig::ejector},
+        {"clamp", &RobotConfig::clamp},
+        {"link_transmitter", &RobotConfig::linkTransmitter},
+    }};
+    static_assert(ls::validateConfigFields(FIELDS), "FIELDS has an empty or duplicate key.");
+
+    RobotConfig load()
+    {
+        RobotConfig config = DEFAULT_CONFIG;
+        const ls::ConfigResult result = ls::loadConfig(ROBOT_CONFIG_FILE, FIELDS, validateConfig, config);
+        if (result.status == ls::ConfigStatus::Invalid) {
+            std::cout << ROBOT_CONFIG_FILE << " is invalid";
+            if (result.line != 0) std::cout << " (line " << result.line << ")";
+            std::cout << ", using the defaults" << std::endl;
+        }
+        return config;
+    }
+}
+
+const RobotConfig& robotConfig()
+{
+    static const RobotConfig config = load();
+    return config;
+}
@@ -0,0 +1,88 @@
+/*
+* Runs two ls::AllianceLink against each other over LoopbackTransport while their paths cross, with every 7th packet
+* lost and garbage injected into one stream, and checks the estimate, the yield decision, staleness and the codec.
+*/
+#include <cmath>
+#include <cstdio>
+#include "alliancelink.h"
+#include "check.h"
+
+int main() {
+    ls::LoopbackTransport transportA, transportB;
+    ls::LoopbackTransport::connect(transportA, transportB);
+    transportB.setLoss(7);
+    ls::AllianceLink a(transportA, {.leader = true});
+    ls::AllianceLink b(transportB, {});
+
+    // A drives east along y = 24, B drives north from (72, 0) across A's path
+    a.setOrigin(24, 24, 90);
+    b.setOrigin(72, 0, 0);
+    a.setTarget(0, 96);
+    b.setTarget(0, 60);
+
+    float maxError = 0;
+    int yieldingA = 0, yieldingB = 0, bothYielding = 0;
+    std::uint32_t now = 0;
+    for (; now <= 3000; now += 10) {
+        a.setPose(0, std::fmin(now / 1000.0 * 30, 96), 0);
+        b.setPose(0, std::fmin(now / 1000.0 * 20, 60), 0);
+        if (now == 1500) {
+            const std::uint8_t garbage[5] = {0xA5, 0x5A, 1, 2, 3}; // starts like a frame
+            transportA.send(garbage, sizeof(garbage));
+        }
+        a.update(now);
+        b.update(now);
+        yieldingA += a.shouldYield();
+        yieldingB += b.shouldYield();
+        bothYielding += a.shouldYield() && b.shouldYield();
+
+        const ls::PartnerEstimate partner = b.getPartner(now);
+        const ls::AlliancePacket local = a.getLocal();
+        CHECK(partner.valid);
+        if (now > 200) maxError = std::fmax(maxError, std::hypot(partner.x - local.x, partner.y - local.y));
+    }
+    const ls::LinkStats statsA = a.getStats(), statsB = b.getStats();
+    std::printf("A received %u lost %u, B received %u lost %u corrupt %u, estimate error %.2f in, yielding A %d B %d both %d ticks\n",
+        statsA.received, statsA.lost, statsB.received, statsB.lost, statsB.corrupt, maxError, yieldingA, yieldingB, bothYielding);
+
+    // every 7th of B's packets is lost, and the link notices each one
+    CHECK(statsA.lost == statsB.sent / 7);
+    CHECK(statsA.received + statsA.lost == statsB.sent - 1); // B sent its last packet after A's last update
+    // the garbage costs its bytes and no packet
+    CHECK(statsB.received == statsA.sent && statsB.lost == 0);
+    CHECK(statsB.corrupt == 5);
+    CHECK(statsA.stale == 0 && statsB.stale == 0);
+
+    CHECK(maxError < 0.5f);
+    CHECK(yieldingA > 0);
+    CHECK(bothYielding == 0);
+    CHECK(!a.shouldYield() && !b.shouldYield()); // both are through
+
+    // A goes quiet
+    for (; now <= 3400; now += 10) b.update(now);
+    CHECK(!b.isPartnerFresh(now) && !b.getPartner(now).valid);
+    CHECK(!b.shouldYield());
+
+    ls::AlliancePacket packet;
+    packet.sequence = 65535;
+    packet.x = 143.27f;
+    packet.y = -3.5f;
+    packet.heading = 271.25f;
+    packet.vx = -80.12f;
+    packet.omega = -400.3f;
+    packet.flags = 0x15;
+    ls::PacketFrame frame;
+    ls::encodePacket(packet, frame);
+    ls::AlliancePacket decoded;
+    CHECK(ls::decodePacket(frame.data(), decoded));
+    CHECK(decoded.sequence == 65535 && decoded.flags == 0x15);
+    CHECK(std::fabs(decoded.x - packet.x) < 0.006f && std::fabs(decoded.y - packet.y) < 0.006f);
+    CHECK(std::fabs(decoded.heading - packet.heading) < 0.006f && std::fabs(decoded.vx - packet.vx) < 0.006f);
+    CHECK(std::fabs(decoded.omega - packet.omega) < 0.06f);
+    for (std::size_t bit = 0; bit < ls::PACKET_SIZE * 8; bit++) {
+        ls::PacketFrame flipped = frame;
+        flipped[bit / 8] ^= 1 << (bit % 8);
+        CHECK(!ls::decodePacket(flipped.data(), decoded));
+    }
+    return test::result();
+}
@@ -0,0 +1,33 @@
+/*
+* Contains the checks the host tests use: a failed CHECK prints where it failed and the test keeps going,
+* main() returns test::result() so `make check` stops on the first test program that failed.
+*/
+#ifndef CHECK_TEST_H
+#define CHECK_TEST_H
+
+#include <cstdio>
+
+namespace test {
+    inline int failures = 0;
+
+    /**
+     * @brief Records a check, printing it if it failed.
+     */
+    inline void check(bool ok, const char* expression, const char* file, int line) {
+        if (ok) return;
+        failures++;
+        std::printf("%s:%d: CHECK(%s) failed\n", file, line, expression);
+    }
+
+    /**
+     * @brief Gets the exit code of the test program.
+     */
+    inline int result() {
+        if (failures != 0) std::printf("%d check(s) failed\n", failures);
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#define CHECK(expression) test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif // CHECK_TEST_H
@@ -0,0 +1,79 @@
+/*
+* Feeds ls::RingClassifier optical samples of rings going past the sensor, with the hue flickering on the edge of
+* its band, the proximity dipping inside the hysteresis and gaps between rings, and checks each ring gives one event.
+*/
+#include <random>
+#include <vector>
+#include "check.h"
+#include "colorsort.h"
+
+namespace {
+    constexpr std::uint64_t PERIOD = 5000; // in µs, the sorter's sample period
+
+    struct Sample {
+        double hue;
+        std::int32_t proximity;
+    };
+
+    /**
+     * @brief Samples of one ring: it comes close, flickers between the enter and exit bands, and leaves.
+     */
+    void ring(std::vector<Sample>& samples, const ls::HueBand& band, std::mt19937& random) {
+        std::uniform_real_distribution<double> inside(-band.enter, band.enter);
+        std::uniform_real_distribution<double> edge(band.enter, band.exit);
+        std::uniform_int_distribution<std::int32_t> near(150, 230);
+        std::uniform_int_distribution<std::int32_t> dip(95, 135); // between the exit and enter proximity
+        samples.push_back({band.center + inside(random), 120}); // not close enough yet
+        for (int i = 0; i < 12; i++) {
+            const double side = i % 2 == 0 ? 1 : -1;
+            const double hue = i < 2 ? band.center + inside(random) : band.center + side * edge(random);
+            samples.push_back({hue < 0 ? hue + 360 : hue, i % 5 == 4 ? dip(random) : near(random)});
+        }
+    }
+
+    void gap(std::vector<Sample>& samples, int count) {
+        for (int i = 0; i < count; i++) samples.push_back({120, 30}); // the conveyor's hue, far away
+    }
+}
+
+int main() {
+    const ls::ColorSortSettings settings;
+    std::mt19937 random(4602);
+    std::vector<Sample> samples;
+    std::vector<ls::RingColor> expected;
+    gap(samples, 10);
+    for (int i = 0; i < 20; i++) {
+        const bool red = random() % 2 == 0;
+        ring(samples, red ? settings.red : settings.blue, random);
+        expected.push_back(red ? ls::RingColor::Red : ls::RingColor::Blue);
+        gap(samples, 1 + i % 3);
+    }
+    // one close sample in the band is noise, not a ring
+    samples.push_back({settings.red.center, 200});
+    gap(samples, 5);
+
+    ls::RingClassifier classifier(settings);
+    std::vector<ls::RingColor> events;
+    std::uint64_t time = 0;
+    for (const Sample& sample : samples) {
+        const ls::RingColor event = classifier.update(sample.hue, sample.proximity, time);
+        if (event != ls::RingColor::None) {
+            events.push_back(event);
+            CHECK(classifier.getCurrent() == event);
+            CHECK(classifier.getSince() == time - PERIOD); // the first of the two confirming samples
+        }
+        time += PERIOD;
+    }
+    CHECK(events == expected);
+    CHECK(classifier.getCurrent() == ls::RingColor::None);
+
+    // a hue far outside the band ends the ring without an event, the next color needs its own two samples
+    classifier.reset();
+    classifier.update(settings.red.center, 200, 0);
+    CHECK(classifier.update(settings.red.center, 200, PERIOD) == ls::RingColor::Red);
+    CHECK(classifier.update(settings.blue.center, 200, 2 * PERIOD) == ls::RingColor::None);
+    CHECK(classifier.getCurrent() == ls::RingColor::None);
+    CHECK(classifier.update(settings.blue.center, 200, 3 * PERIOD) == ls::RingColor::None);
+    CHECK(classifier.update(settings.blue.center, 200, 4 * PERIOD) == ls::RingColor::Blue);
+    return test::result();
+}
@@ -0,0 +1,161 @@
+/*
+* Writes config files to the temp directory and loads them with ls::loadConfig, checking what is accepted, where a
+* rejected file failed and that a rejected file leaves the defaults alone. Also runs the line splitter and value
+* parsers on their own.
+*/
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include "check.h"
+#include "config.h"
+
+namespace {
+    struct TestConfig {
+        float wheelDiameter = 2.75f;
+        std::int8_t imuPort = 5;
+        bool flipped = false;
+        char alliance = 'R';
+        ls::PortList leftPorts{1, 2, 3, 0};
+    };
+
+    constexpr std::array<ls::ConfigField<TestConfig>, 5> FIELDS{{
+        {"wheel_diameter", &TestConfig::wheelDiameter},
+        {"imu_port", &TestConfig::imuPort},
+        {"flipped", &TestConfig::flipped},
+        {"alliance", &TestConfig::alliance},
+        {"left_ports", &TestConfig::leftPorts},
+    }};
+    static_assert(ls::validateConfigFields(FIELDS));
+
+    const std::string PATH = (std::filesystem::temp_directory_path() / "libstoga_config_test.cfg").string();
+
+    bool validate(const TestConfig& config) {
+        return config.wheelDiameter > 0;
+    }
+
+    /**
+     * @brief Writes contents to the test file as is, and loads it over the defaults.
+     */
+    ls::ConfigResult load(const std::string& contents, TestConfig& config) {
+        std::FILE* file = std::fopen(PATH.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+        return ls::loadConfig(PATH.c_str(), FIELDS, validate, config);
+    }
+
+    bool isDefault(const TestConfig& config) {
+        const TestConfig defaults;
+        return config.wheelDiameter == defaults.wheelDiameter && config.imuPort == defaults.imuPort
+            && config.flipped == defaults.flipped && config.alliance == defaults.alliance && config.leftPorts == defaults.leftPorts;
+    }
+
+    /**
+     * @brief Checks that a file is rejected at 'line' and changes nothing, even the keys before the error.
+     */
+    void checkRejected(const std::string& contents, std::uint16_t line) {
+        TestConfig config;
+        const ls::ConfigResult result = load("wheel_diameter = 4\n" + contents, config);
+        const bool ok = result.status == ls::ConfigStatus::Invalid && result.line == line + 1 && isDefault(config);
+        CHECK(ok);
+        if (!ok) std::printf("  rejecting \"%s\" gave line %u\n", contents.c_str(), result.line);
+    }
+
+    /**
+     * @brief A "wheel_diameter = 3" line padded with a comment to 'length' characters.
+     */
+    std::string lineOf(std::size_t length) {
+        std::string line = "wheel_diameter = 3 #";
+        line.resize(length, 'x');
+        return line;
+    }
+}
+
+int main() {
+    // comments, blank lines, CRLF endings and no newline at the end
+    TestConfig config;
+    ls::ConfigResult result = load("# robot\r\n\r\n  wheel_diameter = 3.25 # in\r\nimu_port=-12\r\nflipped = true\r\n"
+        "alliance = B\r\nleft_ports = 11, -12 13", config);
+    CHECK(result.status == ls::ConfigStatus::Loaded && result.line == 0);
+    CHECK(config.wheelDiameter == 3.25f && config.imuPort == -12 && config.flipped && config.alliance == 'B');
+    CHECK((config.leftPorts == ls::PortList{11, -12, 13, 0}));
+    CHECK((ls::usedPorts(config.leftPorts) == std::vector<std::int8_t>{11, -12, 13}));
+
+    // keys that aren't in the file keep their value
+    config = {};
+    CHECK(load("imu_port = 7\n", config).status == ls::ConfigStatus::Loaded);
+    CHECK(config.imuPort == 7 && config.wheelDiameter == 2.75f);
+
+    // nullptr skips the validation
+    config = {};
+    CHECK(load("wheel_diameter = -1\n", config).status == ls::ConfigStatus::Invalid && isDefault(config));
+    result = ls::loadConfig(PATH.c_str(), FIELDS, nullptr, config);
+    CHECK(result.status == ls::ConfigStatus::Loaded && config.wheelDiameter == -1);
+
+    // 127 characters is the limit, without the line ending
+    for (const char* ending : {"\n", "\r\n", ""}) {
+        config = {};
+        result = load(lineOf(127) + ending, config);
+        CHECK(result.status == ls::ConfigStatus::Loaded && config.wheelDiameter == 3);
+        checkRejected(lineOf(128) + ending, 1);
+    }
+    checkRejected(lineOf(500) + "\n", 1);
+    checkRejected("imu_port = 1\n" + lineOf(129) + "\r\n", 2);
+
+    // bad values
+    checkRejected("wheel_diameter = 3.5x\n", 1);
+    checkRejected("wheel_diameter = inf\n", 1);
+    checkRejected("wheel_diameter = nan\n", 1);
+    checkRejected("wheel_diameter = 1e39\n", 1);
+    checkRejected("imu_port = 128\n", 1);
+    checkRejected("imu_port = -129\n", 1);
+    checkRejected("imu_port = 2.5\n", 1);
+    checkRejected("flipped = yes\n", 1);
+    checkRejected("alliance = RB\n", 1);
+    checkRejected("left_ports = 1, 2, 3, 4, 5\n", 1);
+    checkRejected("left_ports = 1, 200\n", 1);
+    checkRejected("left_ports = ,\n", 1);
+    checkRejected("\n# fine so far\nwheel_size = 3\n", 3);
+    checkRejected("wheel_diameter 3\n", 1);
+    checkRejected("= 3\n", 1);
+    checkRejected("imu_port =\n", 1);
+    config = {};
+    CHECK(load("imu_port = -128\nleft_ports = 1 2 3 4\n", config).status == ls::ConfigStatus::Loaded);
+    CHECK(config.imuPort == -128 && (config.leftPorts == ls::PortList{1, 2, 3, 4}));
+
+    // failing the validation has no line
+    config = {};
+    result = load("imu_port = 9\nwheel_diameter = 0\n", config);
+    CHECK(result.status == ls::ConfigStatus::Invalid && result.line == 0 && isDefault(config));
+
+    std::remove(PATH.c_str());
+    config = {};
+    CHECK(ls::loadConfig(PATH.c_str(), FIELDS, validate, config).status == ls::ConfigStatus::Missing && isDefault(config));
+
+    // the pieces on their own
+    char line[] = "  left_ports = 1, 2 # front\r\n";
+    char* key;
+    char* value;
+    CHECK(ls::detail::splitConfigLine(line, key, value) == ls::detail::LineKind::Pair);
+    CHECK(std::string(key) == "left_ports" && std::string(value) == "1, 2");
+    char comment[] = "   # only a comment\r\n";
+    CHECK(ls::detail::splitConfigLine(comment, key, value) == ls::detail::LineKind::Blank);
+    char empty[] = "\r\n";
+    CHECK(ls::detail::splitConfigLine(empty, key, value) == ls::detail::LineKind::Blank);
+    char noValue[] = "key = # nothing\n";
+    CHECK(ls::detail::splitConfigLine(noValue, key, value) == ls::detail::LineKind::Malformed);
+
+    float number = 1;
+    CHECK(ls::detail::parseConfigValue("-0.5e1", number) && number == -5);
+    CHECK(!ls::detail::parseConfigValue("-inf", number) && !ls::detail::parseConfigValue("", number) && number == -5);
+    std::int8_t port = 1;
+    CHECK(ls::detail::parseConfigValue("127", port) && port == 127);
+    CHECK(!ls::detail::parseConfigValue("0x10", port) && port == 127);
+    bool flag = false;
+    CHECK(ls::detail::parseConfigValue("1", flag) && flag && ls::detail::parseConfigValue("false", flag) && !flag);
+    char letter = 'R';
+    CHECK(!ls::detail::parseConfigValue("", letter) && letter == 'R');
+    ls::PortList ports{9, 9, 9, 9};
+    CHECK(!ls::detail::parseConfigValue("1 2 3 4 5", ports) && (ports == ls::PortList{9, 9, 9, 9}));
+    CHECK(ls::detail::parseConfigValue("-1,2", ports) && (ports == ls::PortList{-1, 2, 0, 0}));
+    return test::result();
+}
@@ -0,0 +1,127 @@
+/*
+* Steps ls::SlewLimiter and ls::TractionControl through the cases driver control runs into: speeding up and slowing
+* down at their own rates, reversing through zero, backing off while the wheels slip and recovering after.
+*/
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "check.h"
+#include "drive.h"
+
+namespace {
+    constexpr float DT = 0.01f; // the 10ms drive tick, in s
+    constexpr float EPSILON = 1e-5f;
+
+    /**
+     * @brief Updates the limiter towards target until it gets there, and gives the number of ticks it took.
+     */
+    int ticksTo(ls::SlewLimiter& limiter, float target) {
+        int ticks = 0;
+        while (std::fabs(limiter.get() - target) > EPSILON && ticks < 1000) {
+            const float before = limiter.get();
+            limiter.update(target, DT);
+            // it only moves towards the target
+            CHECK(std::fabs(limiter.get() - target) < std::fabs(before - target) + EPSILON);
+            ticks++;
+        }
+        limiter.reset(target); // drops the float residue, so a following reversal doesn't start on the wrong side of 0
+        return ticks;
+    }
+}
+
+int main() {
+    // 4/s up, 10/s down: 0 to full in 25 ticks, back down in 10, the same backwards
+    ls::SlewLimiter limiter(4, 10);
+    CHECK(std::fabs(limiter.update(1, DT) - 0.04f) < EPSILON);
+    CHECK(ticksTo(limiter, 1) == 24);
+    CHECK(std::fabs(limiter.update(0.5f, DT) - 0.9f) < EPSILON);
+    CHECK(ticksTo(limiter, 0.5f) == 4);
+    CHECK(ticksTo(limiter, 0) == 5);
+    CHECK(ticksTo(limiter, -1) == 25);
+    CHECK(ticksTo(limiter, 0) == 10);
+    // a small change inside one step lands exactly
+    CHECK(limiter.update(0.01f, DT) == 0.01f);
+
+    // reversing from full forward slows to 0 at the decel rate first, then speeds up at the accel rate
+    limiter.reset(1);
+    int ticks = 0;
+    float previous = limiter.get();
+    while (limiter.get() > 0) {
+        limiter.update(-1, DT);
+        CHECK(std::fabs(previous - limiter.get() - 0.1f) < EPSILON);
+        previous = limiter.get();
+        ticks++;
+    }
+    CHECK(ticks == 10 && limiter.get() == 0);
+    CHECK(std::fabs(limiter.update(-1, DT) + 0.04f) < EPSILON);
+    std::printf("reversal: %d ticks to stop, then %.2f per tick\n", ticks, -limiter.get());
+    // and the other way
+    limiter.reset(-0.35f);
+    limiter.update(0.8f, DT);
+    CHECK(std::fabs(limiter.get() + 0.25f) < EPSILON);
+
+    // a slow decel rate is still used for slowing down, not the accel rate
+    ls::SlewLimiter gentle(10, 2);
+    gentle.reset(1);
+    CHECK(std::fabs(gentle.update(0, DT) - 0.98f) < EPSILON);
+
+    bool threw = false;
+    try {
+        ls::SlewLimiter(0, 10);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // gripping at speed: full power
+    const ls::TractionConfig config;
+    ls::TractionControl traction(config);
+    traction.update(40, 38, 2500);
+    CHECK(!traction.isSlipping() && traction.getScale() == 1);
+
+    // spinning out: backs off by 0.1 a tick down to minScale and stays there
+    int slipTicks = 0;
+    for (; slipTicks < 20; slipTicks++) {
+        traction.update(40, 10, 2500);
+        CHECK(traction.isSlipping());
+        CHECK(traction.getScale() >= config.minScale);
+    }
+    CHECK(traction.getScale() == config.minScale);
+    CHECK(std::fabs(traction.apply(0.5f) - 0.5f * config.minScale) < EPSILON);
+
+    // grip again: gives back 0.05 a tick up to 1, no further
+    int recoveryTicks = 0;
+    while (traction.getScale() < 1) {
+        traction.update(40, 39, 2500);
+        CHECK(!traction.isSlipping());
+        recoveryTicks++;
+    }
+    std::printf("traction: down to %.2f, back to 1 in %d ticks\n", config.minScale, recoveryTicks);
+    CHECK(recoveryTicks == 12);
+    traction.update(40, 39, 2500);
+    CHECK(traction.getScale() == 1);
+
+    // driving backwards the ground speed is negative too, that is grip
+    traction.update(-40, -38, 2500);
+    CHECK(!traction.isSlipping());
+    // wheels spinning backwards while the robot barely moves, or is pushed forwards, is slip
+    traction.update(-40, -10, 2500);
+    CHECK(traction.isSlipping());
+    traction.update(-40, 5, 2500);
+    CHECK(traction.isSlipping());
+    // as is spinning forwards while being pushed backwards
+    traction.update(40, -5, 2500);
+    CHECK(traction.isSlipping());
+
+    // too slow, or not pushing hard enough, is never slip
+    traction.reset();
+    CHECK(traction.getScale() == 1 && !traction.isSlipping());
+    traction.update(config.minSpeed, 0, 2500);
+    CHECK(!traction.isSlipping());
+    traction.update(-config.minSpeed, 0, 2500);
+    CHECK(!traction.isSlipping());
+    traction.update(40, 0, config.currentThreshold);
+    CHECK(!traction.isSlipping());
+    CHECK(traction.getScale() == 1);
+    return test::result();
+}
@@ -0,0 +1,103 @@
+/*
+* Sweeps ls::fastmath against libm and checks the max errors documented in fastmath.h,
+* then times fastmath against libm over a large array.
+* The timings are for the host, they only show the ratio to expect on the brain.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "check.h"
+#include "fastmath.h"
+
+namespace fm = ls::fastmath;
+
+namespace {
+    struct Errors {
+        double sin = 0;
+        double cos = 0;
+        double atan2 = 0;
+        double hypot = 0; // relative
+    };
+
+    /**
+     * @brief Max errors of T against double libm, sin/cos over [-limit, limit] and atan2/hypot in every direction.
+     */
+    template<typename T>
+    Errors sweep(double limit) {
+        Errors errors;
+        const double step = limit / 2e6;
+        for (double x = -limit; x <= limit; x += step) {
+            const T t = static_cast<T>(x);
+            errors.sin = std::max(errors.sin, std::fabs(static_cast<double>(fm::sin(t)) - std::sin(static_cast<double>(t))));
+            errors.cos = std::max(errors.cos, std::fabs(static_cast<double>(fm::cos(t)) - std::cos(static_cast<double>(t))));
+        }
+        for (double a = -ls::PI; a <= ls::PI; a += 1e-5) {
+            for (double r : {1e-3, 1.0, 144.0, 1e4}) {
+                const T y = static_cast<T>(r * std::sin(a));
+                const T x = static_cast<T>(r * std::cos(a));
+                const double exact = std::atan2(static_cast<double>(y), static_cast<double>(x));
+                errors.atan2 = std::max(errors.atan2, std::fabs(static_cast<double>(fm::atan2(y, x)) - exact));
+                const double length = std::hypot(static_cast<double>(x), static_cast<double>(y));
+                errors.hypot = std::max(errors.hypot, std::fabs(static_cast<double>(fm::hypot(x, y)) - length) / length);
+            }
+        }
+        return errors;
+    }
+
+    /**
+     * @brief Runs f and gives the time it took per element, in ns.
+     */
+    template<typename F>
+    double time(F f, std::size_t count) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / count;
+    }
+
+    volatile double sink; // keeps the timed loops from being optimized out
+}
+
+int main() {
+    // the bounds documented in fastmath.h
+    const Errors d = sweep<double>(1e3);
+    std::printf("double |x| < 1e3: sin %.3g cos %.3g atan2 %.3g hypot %.3g (relative)\n", d.sin, d.cos, d.atan2, d.hypot);
+    CHECK(d.sin <= 3.4e-9);
+    CHECK(d.cos <= 2.2e-10);
+    CHECK(d.atan2 <= 1.2e-10);
+    CHECK(d.hypot <= 1e-15);
+
+    const Errors f = sweep<float>(2 * ls::PI);
+    std::printf("float |x| < 2pi: sin %.3g cos %.3g atan2 %.3g hypot %.3g (relative)\n", f.sin, f.cos, f.atan2, f.hypot);
+    CHECK(f.sin <= 2.2e-7);
+    CHECK(f.cos <= 3.0e-7);
+    CHECK(f.atan2 <= 2.8e-7);
+    CHECK(f.hypot <= 2.4e-7);
+
+    CHECK(fm::atan2(0.0, 0.0) == 0.0);
+    CHECK(fm::atan2(0.0, -1.0) == ls::PI);
+
+    constexpr std::size_t COUNT = 1 << 20;
+    std::vector<double> in(COUNT), out(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++) in[i] = i * 0.0013 - 600;
+    std::vector<float> inF(in.begin(), in.end()), outF(COUNT);
+
+    const double sinLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::sin(in[i]); }, COUNT);
+    const double sinFast = time([&]() { fm::sin(in.data(), out.data(), COUNT); }, COUNT);
+    const double sinLibmF = time([&]() { for (std::size_t i = 0; i < COUNT; i++) outF[i] = std::sin(inF[i]); }, COUNT);
+    const double sinFastF = time([&]() { fm::sin(inF.data(), outF.data(), COUNT); }, COUNT);
+    const double atanLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::atan2(in[i], 1.3); }, COUNT);
+    const double atanFast = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = fm::atan2(in[i], 1.3); }, COUNT);
+    const double hypotLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::hypot(in[i], 1.3); }, COUNT);
+    const double hypotFast = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = fm::hypot(in[i], 1.3); }, COUNT);
+    sink = out[COUNT / 2] + outF[COUNT / 2];
+
+    std::printf("ns per call     libm   fastmath\n");
+    std::printf("sin double    %6.2f   %6.2f (batch)\n", sinLibm, sinFast);
+    std::printf("sin float     %6.2f   %6.2f (batch)\n", sinLibmF, sinFastF);
+    std::printf("atan2 double  %6.2f   %6.2f\n", atanLibm, atanFast);
+    std::printf("hypot double  %6.2f   %6.2f\n", hypotLibm, hypotFast);
+    return test::result();
+}
@@ -0,0 +1,61 @@
+/*
+* Fits ls::FeedforwardFit to simulated quasistatic and dynamic runs of a drive with known gains,
+* with noise on the voltage, and checks the gains come back. Also round trips the gains file.
+*/
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "check.h"
+#include "feedforward.h"
+
+namespace {
+    constexpr ls::FeedforwardGains TRUE_GAINS{0.8, 0.12, 0.03};
+    constexpr double NOISE = 0.05; // in volts, standard deviation
+
+    /**
+     * @brief Simulates a drive following V = kS sign(v) + kV v + kA a at 10ms ticks and feeds the fit.
+     */
+    void simulate(ls::FeedforwardFit& fit, std::mt19937& random, bool quasistatic, double direction) {
+        std::normal_distribution<double> noise(0, NOISE);
+        double velocity = 0;
+        for (int tick = 0; tick < (quasistatic ? 1000 : 150); tick++) {
+            const double volts = direction * (quasistatic ? 0.5 * tick * 0.01 : 6.0);
+            // the drive only moves once the voltage beats static friction
+            double acceleration = 0;
+            if (std::fabs(volts) > TRUE_GAINS.kS) {
+                acceleration = (volts - TRUE_GAINS.kS * direction - TRUE_GAINS.kV * velocity) / TRUE_GAINS.kA;
+            }
+            fit.add(volts + noise(random), velocity, acceleration);
+            velocity += acceleration * 0.01;
+        }
+    }
+}
+
+int main() {
+    std::mt19937 random(6121);
+    ls::FeedforwardFit fit(0.5);
+    for (double direction : {1.0, -1.0}) {
+        simulate(fit, random, true, direction);
+        simulate(fit, random, false, direction);
+    }
+    const ls::FeedforwardGains gains = fit.solve();
+    std::printf("kS %.4f kV %.5f kA %.5f r^2 %.5f, %zu samples\n", gains.kS, gains.kV, gains.kA, fit.getRSquared(), fit.getCount());
+    CHECK(std::fabs(gains.kS - TRUE_GAINS.kS) < 0.01);
+    CHECK(std::fabs(gains.kV - TRUE_GAINS.kV) < 0.001);
+    CHECK(std::fabs(gains.kA - TRUE_GAINS.kA) < 0.001);
+    CHECK(fit.getRSquared() > 0.999);
+
+    // one kind of run can't tell the terms apart
+    ls::FeedforwardFit still;
+    for (int i = 0; i < 10; i++) still.add(3, 10, 0);
+    CHECK(still.solve().kV == 0);
+
+    const char* path = "build/feedforward_test.txt";
+    CHECK(ls::saveFeedforward(path, gains, TRUE_GAINS));
+    ls::FeedforwardGains linear, angular;
+    CHECK(ls::loadFeedforward(path, linear, angular));
+    CHECK(std::fabs(linear.kV - gains.kV) < 1e-8 && angular.kA == TRUE_GAINS.kA);
+    std::remove(path);
+    CHECK(!ls::loadFeedforward(path, linear, angular));
+    return test::result();
+}
@@ -0,0 +1,57 @@
+/*
+* Runs the ls::FieldView drawing task on the stubbed screen: one full frame, a robot driving and turning,
+* then standing still, and checks how many field pixels each part redraws.
+*/
+#include <cmath>
+#include <cstdio>
+#include "check.h"
+#include "fieldview.h"
+#include "prosstub.h"
+
+namespace {
+    constexpr std::uint32_t PERIOD = 50; // in ms, FieldView's default
+    constexpr int DRIVE_FRAMES = 200;
+    constexpr int STILL_FRAMES = 40;
+}
+
+int main() {
+    ls::FieldView view;
+    std::uint32_t frame = 0;
+    std::uint32_t firstFrames = 0, drivingFrames = 0;
+    std::uint64_t firstPixels = 0, drivingPixels = 0;
+
+    // called between frames: the robot drives an arc at 30 in/s turning 45 deg/s, then stops
+    test::onDelay([&]() {
+        frame++;
+        if (frame == 1) {
+            firstFrames = view.getFrames();
+            firstPixels = view.getRedrawnPixels();
+        }
+        if (frame <= DRIVE_FRAMES) {
+            const double t = frame * PERIOD / 1000.0;
+            const double heading = 45 * t;
+            const double radius = 30 / (45 * ls::PI / 180);
+            view.setPose(ls::Position(radius * (1 - std::cos(heading * ls::PI / 180)), radius * std::sin(heading * ls::PI / 180), heading));
+        }
+        if (frame == DRIVE_FRAMES + 1) {
+            drivingFrames = view.getFrames() - firstFrames;
+            drivingPixels = view.getRedrawnPixels() - firstPixels;
+        }
+        if (frame == DRIVE_FRAMES + STILL_FRAMES) view.stop();
+    });
+    view.start();
+    test::runTasks();
+
+    std::printf("first frame %llu px, driving %u frames %.0f px/frame, still %u frames %llu px\n",
+        static_cast<unsigned long long>(firstPixels), drivingFrames, static_cast<double>(drivingPixels) / drivingFrames,
+        view.getFrames() - firstFrames - drivingFrames,
+        static_cast<unsigned long long>(view.getRedrawnPixels() - firstPixels - drivingPixels));
+    CHECK(firstFrames == 1);
+    CHECK(firstPixels == ls::FieldView::FIELD_PIXELS * ls::FieldView::FIELD_PIXELS);
+    CHECK(drivingFrames == DRIVE_FRAMES);
+    CHECK(drivingPixels < 0.05 * DRIVE_FRAMES * firstPixels);
+    CHECK(view.getFrames() == firstFrames + drivingFrames);
+    CHECK(view.getRedrawnPixels() == firstPixels + drivingPixels);
+    CHECK(test::filledPixels() == view.getRedrawnPixels()); // nothing outside the dirty rectangles is filled
+    return test::result();
+}
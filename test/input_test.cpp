@@ -0,0 +1,104 @@
+/*
+* Replays button presses into ls::Input through update(controller, snapshot, time) at the 20ms opcontrol tick
+* and checks the debounce, double tap and hold timings documented in InputTiming.
+*/
+#include "check.h"
+#include "input.h"
+
+namespace {
+    constexpr std::uint32_t TICK = 20; // in ms
+
+    /**
+     * @brief Feeds the master controller with A down or up, one snapshot per tick, and counts A's events.
+     */
+    struct Replay {
+        ls::Input input;
+        std::uint32_t now = 0;
+        int presses = 0, releases = 0, holds = 0, doubleTaps = 0;
+
+        Replay() {
+            input.on(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::Press, [this]() { presses++; });
+            input.on(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::Release, [this]() { releases++; });
+            input.on(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::Hold, [this]() { holds++; });
+            input.on(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::DoubleTap, [this]() { doubleTaps++; });
+        }
+
+        /**
+         * @brief Gives the same state for 'ms', then moves the clock past it.
+         */
+        void run(bool down, std::uint32_t ms) {
+            ls::ControllerSnapshot raw;
+            raw.connected = true;
+            raw.buttons = down ? 1u << static_cast<std::uint8_t>(ls::Button::A) : 0;
+            for (std::uint32_t end = now + ms; now < end; now += TICK) {
+                input.update(ls::ControllerId::Master, raw, now);
+            }
+        }
+
+        void reset() {
+            presses = releases = holds = doubleTaps = 0;
+        }
+    };
+}
+
+int main() {
+    Replay replay;
+    replay.now = 1000;
+
+    // contact bounce inside 30ms of an edge is ignored, the first edge is not delayed
+    replay.run(true, TICK);
+    CHECK(replay.presses == 1 && replay.input.isDown(ls::ControllerId::Master, ls::Button::A));
+    replay.run(false, TICK); // 20ms after the press
+    CHECK(replay.releases == 0 && replay.input.isDown(ls::ControllerId::Master, ls::Button::A));
+    replay.run(true, 200);
+    replay.run(false, TICK);
+    CHECK(replay.presses == 1 && replay.releases == 1);
+    replay.run(true, TICK); // 20ms after the release
+    CHECK(replay.presses == 1 && !replay.input.isDown(ls::ControllerId::Master, ls::Button::A));
+    replay.run(false, 1000);
+    CHECK(replay.doubleTaps == 0 && replay.holds == 0);
+
+    // two taps 200ms apart are a double tap, the third tap starts a new one
+    replay.reset();
+    replay.run(true, 100);
+    replay.run(false, 100);
+    replay.run(true, TICK);
+    CHECK(replay.presses == 2 && replay.doubleTaps == 1);
+    CHECK(replay.input.was(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::DoubleTap));
+    replay.run(true, 80);
+    CHECK(!replay.input.was(ls::ControllerId::Master, ls::Button::A, ls::ButtonEvent::DoubleTap));
+    replay.run(false, 100);
+    replay.run(true, 100);
+    CHECK(replay.presses == 3 && replay.doubleTaps == 1);
+    replay.run(false, 1000);
+
+    // taps further apart than 300ms are two presses
+    replay.reset();
+    replay.run(true, 160);
+    replay.run(false, 160);
+    replay.run(true, 100);
+    CHECK(replay.presses == 2 && replay.doubleTaps == 0);
+    replay.run(false, 1000);
+
+    // a hold fires once, 500ms into the press
+    replay.reset();
+    replay.run(true, 500);
+    CHECK(replay.holds == 0);
+    replay.run(true, TICK);
+    CHECK(replay.holds == 1);
+    replay.run(true, 1000);
+    CHECK(replay.holds == 1 && replay.releases == 0);
+
+    // a hold is not the first half of a double tap
+    replay.run(false, 100);
+    replay.run(true, 100);
+    CHECK(replay.presses == 2 && replay.doubleTaps == 0 && replay.releases == 1);
+    replay.run(false, 1000);
+
+    // a disconnected controller reads as centered with nothing down
+    ls::ControllerSnapshot gone;
+    replay.input.update(ls::ControllerId::Partner, gone, replay.now);
+    CHECK(!replay.input.get(ls::ControllerId::Partner).connected);
+    CHECK(replay.input.getAxis(ls::ControllerId::Partner, ls::Axis::LeftY) == 0);
+    return test::result();
+}
@@ -0,0 +1,195 @@
+/*
+* Sweeps the fixed-point Numeric policy against double and checks the max errors documented in numeric.h,
+* checks Fixed arithmetic and its division by zero saturation, runs BasicPID on fixed point next to double,
+* then times the tables against libm. The timings are for the host, they only show the ratio to expect on the brain.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include "check.h"
+#include "pid.h"
+
+namespace {
+    struct Errors {
+        double sin = 0;
+        double cos = 0;
+        double atan2 = 0;
+        double sqrt = 0; // absolute for Q16.16, relative for Q32.32
+        double sqrtRoot = 0; // against the exact root of the T value itself: in LSBs for Q16.16, relative for Q32.32
+    };
+
+    /**
+     * @brief Max errors of Fixed type T against double: sin/cos over [-4pi, 4pi], atan2 in every direction
+     * at 1, 144 and 10000 in, sqrt over [0.01, 10000].
+     */
+    template<typename T>
+    Errors sweep(bool relativeSqrt) {
+        using N = ls::Numeric<T>;
+        Errors errors;
+        for (double x = -4 * ls::PI; x <= 4 * ls::PI; x += 1e-5) {
+            // against the double the caller had, so rounding x to T counts too
+            const T t(x);
+            errors.sin = std::max(errors.sin, std::fabs(N::sin(t).toDouble() - std::sin(x)));
+            errors.cos = std::max(errors.cos, std::fabs(N::cos(t).toDouble() - std::cos(x)));
+        }
+        for (double a = -ls::PI; a <= ls::PI; a += 1e-5) {
+            for (double r : {1.0, 144.0, 1e4}) {
+                const double y = r * std::sin(a);
+                const double x = r * std::cos(a);
+                // y rounding to 0 can flip pi to -pi, the same direction
+                const double error = std::remainder(N::atan2(T(y), T(x)).toDouble() - std::atan2(y, x), ls::TAU);
+                errors.atan2 = std::max(errors.atan2, std::fabs(error));
+            }
+        }
+        for (double x = 0.01; x <= 1e4; x *= 1.00001) {
+            const double exact = std::sqrt(x);
+            const double error = std::fabs(N::sqrt(T(x)).toDouble() - exact);
+            errors.sqrt = std::max(errors.sqrt, relativeSqrt ? error / exact : error);
+            const T t(x);
+            const double root = std::sqrt(t.toDouble());
+            const double rootError = std::fabs(N::sqrt(t).toDouble() - root);
+            errors.sqrtRoot = std::max(errors.sqrtRoot, relativeSqrt ? rootError / root : rootError * T::ONE);
+        }
+        return errors;
+    }
+
+    /**
+     * @brief Checks Fixed * and / on random operands against the exact result, worked out in 128 bits on the host.
+     * Both truncate instead of rounding, so they must be off by less than one LSB.
+     */
+    template<typename T>
+    void checkArithmetic(double range, std::mt19937& random) {
+        std::uniform_real_distribution<double> operand(-range, range);
+        int wrong = 0;
+        for (int i = 0; i < 200000; i++) {
+            const T a(operand(random));
+            const T b(operand(random));
+            const __int128 product = static_cast<__int128>(a.getRaw()) * b.getRaw();
+            const __int128 mulError = (static_cast<__int128>((a * b).getRaw()) << T::FRACTIONAL_BITS) - product;
+            if (mulError >= T::ONE || mulError <= -static_cast<__int128>(T::ONE)) wrong++;
+            if (b.getRaw() == 0) continue;
+            const __int128 dividend = static_cast<__int128>(a.getRaw()) << T::FRACTIONAL_BITS;
+            const __int128 divError = static_cast<__int128>((a / b).getRaw()) * b.getRaw() - dividend;
+            const __int128 divisor = b.getRaw() < 0 ? -static_cast<__int128>(b.getRaw()) : b.getRaw();
+            if (std::abs(static_cast<double>(dividend) / divisor) < std::numeric_limits<typename T::storage_type>::max()
+                && (divError >= divisor || divError <= -divisor)) wrong++;
+        }
+        CHECK(wrong == 0);
+        CHECK(T(1.5) * T(-2.25) == T(-3.375));
+        CHECK(T(-3.375) / T(1.5) == T(-2.25));
+        CHECK(T(7) - T(2.5) == T(4.5) && -T(4.5) == T(-4.5));
+    }
+
+    /**
+     * @brief Division by zero saturates to the largest value of the dividend's sign.
+     */
+    template<typename T>
+    void checkSaturation() {
+        using Storage = typename T::storage_type;
+        CHECK((T(3) / T()).getRaw() == std::numeric_limits<Storage>::max());
+        CHECK((T(-3) / T()).getRaw() == std::numeric_limits<Storage>::min());
+        CHECK((T() / T()).getRaw() == std::numeric_limits<Storage>::max());
+    }
+
+    /**
+     * @brief Runs a PID on T and on double over the same errors, and gives the largest difference in output.
+     */
+    template<typename T>
+    double pidDifference() {
+        ls::BasicPID<T> fixed(T(8), T(0.05), T(30), T(3), true);
+        ls::BasicPID<double> reference(8, 0.05, 30, 3, true);
+        double difference = 0;
+        for (int i = 0; i < 500; i++) {
+            const double error = 24 * std::exp(-i / 100.0) * std::cos(i / 15.0); // a settling, overshooting move
+            const double output = fixed.update(T(error)).toDouble();
+            difference = std::max(difference, std::fabs(output - reference.update(T(error).toDouble())));
+        }
+        return difference;
+    }
+
+    /**
+     * @brief Runs f and gives the time it took per element, in ns.
+     */
+    template<typename F>
+    double time(F f, std::size_t count) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / count;
+    }
+
+    volatile double sink; // keeps the timed loops from being optimized out
+}
+
+int main() {
+    // the bounds documented in numeric.h
+    const Errors q16 = sweep<ls::Q16_16>(false);
+    std::printf("Q16.16: sin %.3g cos %.3g atan2 %.3g sqrt %.3g (absolute, %.2f LSB from the exact root)\n",
+        q16.sin, q16.cos, q16.atan2, q16.sqrt, q16.sqrtRoot);
+    CHECK(q16.sin <= 3.5e-5);
+    CHECK(q16.cos <= 3.5e-5);
+    CHECK(q16.atan2 <= 5.3e-5);
+    CHECK(q16.sqrt <= 5.2e-5);
+    CHECK(q16.sqrtRoot <= 1);
+
+    const Errors q32 = sweep<ls::Q32_32>(true);
+    std::printf("Q32.32: sin %.3g cos %.3g atan2 %.3g sqrt %.3g (relative, %.3g from the exact root)\n",
+        q32.sin, q32.cos, q32.atan2, q32.sqrt, q32.sqrtRoot);
+    CHECK(q32.sin <= 4.8e-6);
+    CHECK(q32.cos <= 4.8e-6);
+    CHECK(q32.atan2 <= 1.3e-6);
+    CHECK(q32.sqrt <= 8e-9);
+    CHECK(q32.sqrtRoot <= 2.4e-9); // one LSB of the smallest root
+
+    using N16 = ls::Numeric<ls::Q16_16>;
+    CHECK(N16::atan2(ls::Q16_16(), ls::Q16_16()) == ls::Q16_16());
+    CHECK(N16::sqrt(ls::Q16_16(-4)) == ls::Q16_16());
+    CHECK(N16::sqrt(ls::Q16_16(144)) == ls::Q16_16(12));
+    CHECK(ls::Numeric<ls::Q32_32>::sqrt(ls::Q32_32(2.25)) == ls::Q32_32(1.5));
+
+    std::mt19937 random(2901);
+    checkArithmetic<ls::Q16_16>(150, random);
+    checkArithmetic<ls::Q32_32>(1e4, random);
+    checkSaturation<ls::Q16_16>();
+    checkSaturation<ls::Q32_32>();
+
+    const double pid16 = pidDifference<ls::Q16_16>();
+    const double pid32 = pidDifference<ls::Q32_32>();
+    std::printf("PID output against double: Q16.16 %.3g, Q32.32 %.3g\n", pid16, pid32);
+    CHECK(pid16 < 1e-2);
+    CHECK(pid32 < 1e-6);
+
+    constexpr std::size_t COUNT = 1 << 20;
+    std::vector<double> in(COUNT), out(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++) in[i] = i * 2.4e-5 - 12.5;
+    std::vector<ls::Q16_16> in16(COUNT), out16(COUNT);
+    std::vector<ls::Q32_32> in32(COUNT), out32(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++) {
+        in16[i] = ls::Q16_16(in[i]);
+        in32[i] = ls::Q32_32(in[i]);
+    }
+    using N32 = ls::Numeric<ls::Q32_32>;
+    const ls::Q16_16 one16(1.3);
+    const ls::Q32_32 one32(1.3);
+
+    const double sinLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::sin(in[i]); }, COUNT);
+    const double sin16 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out16[i] = N16::sin(in16[i]); }, COUNT);
+    const double sin32 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out32[i] = N32::sin(in32[i]); }, COUNT);
+    const double atanLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::atan2(in[i], 1.3); }, COUNT);
+    const double atan16 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out16[i] = N16::atan2(in16[i], one16); }, COUNT);
+    const double atan32 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out32[i] = N32::atan2(in32[i], one32); }, COUNT);
+    const double sqrtLibm = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out[i] = std::sqrt(std::fabs(in[i])); }, COUNT);
+    const double sqrt16 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out16[i] = N16::sqrt(N16::abs(in16[i])); }, COUNT);
+    const double sqrt32 = time([&]() { for (std::size_t i = 0; i < COUNT; i++) out32[i] = N32::sqrt(N32::abs(in32[i])); }, COUNT);
+    sink = out[COUNT / 2] + out16[COUNT / 2].toDouble() + out32[COUNT / 2].toDouble();
+
+    std::printf("ns per call     libm   Q16.16   Q32.32\n");
+    std::printf("sin           %6.2f   %6.2f   %6.2f\n", sinLibm, sin16, sin32);
+    std::printf("atan2         %6.2f   %6.2f   %6.2f\n", atanLibm, atan16, atan32);
+    std::printf("sqrt          %6.2f   %6.2f   %6.2f\n", sqrtLibm, sqrt16, sqrt32);
+    return test::result();
+}
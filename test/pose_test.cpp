@@ -0,0 +1,86 @@
+/*
+* Checks the SE(2) exp/log maps in pose.h: they invert each other, the Taylor series near zero rotation agree with
+* the closed forms on both sides of SMALL_ANGLE, a straight twist is a plain translation, and a circle closes.
+*/
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "check.h"
+#include "pose.h"
+
+namespace {
+    using Pose = ls::Pose2<double>;
+    using Twist = ls::Twist2<double>;
+
+    /**
+     * @brief exp() worked out in long double, the reference for the Taylor path. (1 - cos(w))/w is written as
+     * 2sin²(w/2)/w so it doesn't cancel near 0.
+     */
+    Pose exactExp(const Twist& twist) {
+        const long double w = twist.dtheta;
+        const long double a = w == 0 ? 1 : std::sin(w) / w;
+        const long double half = std::sin(w / 2);
+        const long double b = w == 0 ? 0 : 2 * half * half / w;
+        return {static_cast<double>(a * twist.dx - b * twist.dy), static_cast<double>(b * twist.dx + a * twist.dy),
+            {static_cast<double>(std::cos(w)), static_cast<double>(std::sin(w))}};
+    }
+
+    double distance(const Pose& p, const Pose& q) {
+        return std::fmax(std::fmax(std::fabs(p.x - q.x), std::fabs(p.y - q.y)),
+            std::fmax(std::fabs(p.rotation.c - q.rotation.c), std::fabs(p.rotation.s - q.rotation.s)));
+    }
+}
+
+int main() {
+    // exp then log gives the twist back, over [-3, 3] rad and one tick's worth of travel
+    std::mt19937 random(3101);
+    std::uniform_real_distribution<double> turn(-3, 3);
+    std::uniform_real_distribution<double> travel(-1, 1);
+    double roundTrip = 0;
+    for (int i = 0; i < 100000; i++) {
+        const Twist twist{travel(random), travel(random), i % 2 == 0 ? turn(random) : turn(random) * 1e-2};
+        const Twist back = Pose::exp(twist).log();
+        roundTrip = std::fmax(roundTrip, std::fmax(std::fmax(std::fabs(back.dx - twist.dx), std::fabs(back.dy - twist.dy)),
+            std::fabs(back.dtheta - twist.dtheta)));
+    }
+    std::printf("exp/log round trip %.3g\n", roundTrip);
+    CHECK(roundTrip < 7e-16);
+
+    // the series near 0 and at the switch to the closed forms
+    double series = 0;
+    for (double w : {0.0, 1e-300, 1e-12, 1e-6, 1e-3, 0.01, ls::SMALL_ANGLE - 1e-12, ls::SMALL_ANGLE, ls::SMALL_ANGLE + 1e-12, 0.1}) {
+        for (double sign : {1.0, -1.0}) {
+            const Twist twist{0.8, -0.3, sign * w};
+            series = std::fmax(series, distance(Pose::exp(twist), exactExp(twist)));
+            const Twist back = Pose::exp(twist).log();
+            series = std::fmax(series, std::fabs(back.dtheta - twist.dtheta) + std::fabs(back.dx - 0.8) + std::fabs(back.dy + 0.3));
+        }
+    }
+    std::printf("series against closed form %.3g\n", series);
+    CHECK(series < 2e-15); // the closed form just above SMALL_ANGLE is the worst
+
+    // no heading change is a plain translation, exactly
+    const Pose straight = Pose::exp({12.5, -3.25, 0});
+    CHECK(straight.x == 12.5 && straight.y == -3.25 && straight.rotation.c == 1 && straight.rotation.s == 0);
+    const Twist straightBack = straight.log();
+    CHECK(straightBack.dx == 12.5 && straightBack.dy == -3.25 && straightBack.dtheta == 0);
+    CHECK(Pose{}.log().dx == 0 && Pose{}.log().dtheta == 0);
+
+    // driving a full circle of radius 24 in 1000 ticks comes back to the start, like AbstractOdom::integrate()
+    constexpr int STEPS = 1000;
+    const Twist step{ls::TAU * 24 / STEPS, 0, ls::TAU / STEPS};
+    Pose pose;
+    for (int i = 0; i < STEPS; i++) {
+        pose = pose * Pose::exp(step);
+        pose.rotation = pose.rotation.normalized();
+    }
+    const double closure = distance(pose, Pose{});
+    std::printf("circle closes to %.3g\n", closure);
+    CHECK(closure < 6e-15);
+
+    // half way round it is across the circle, facing back
+    Pose half;
+    for (int i = 0; i < STEPS / 2; i++) half = half * Pose::exp(step);
+    CHECK(std::fabs(half.x) < 1e-12 && std::fabs(half.y - 48) < 1e-12 && std::fabs(half.rotation.c + 1) < 1e-12);
+    return test::result();
+}
@@ -0,0 +1,87 @@
+/*
+* Samples ls::TrapezoidProfile every ms for the shapes a move can take and checks each one starts where it was asked,
+* is continuous, stays in its limits and ends on the goal at rest.
+*/
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "check.h"
+#include "profile.h"
+
+namespace {
+    constexpr ls::ProfileConstraints LIMITS{360, 1800}; // deg/s and deg/s², the arm's
+    constexpr double DT = 1e-3; // in seconds
+    constexpr double EPSILON = 1e-9;
+
+    /**
+     * @brief Checks one profile and gives its peak speed.
+     *
+     * @param name printed with the failed checks.
+     * @param startVelocity what the profile should start at, after dropping the part away from the goal.
+     * @param maxAcceleration the largest acceleration it may use.
+     */
+    double check(const char* name, const ls::TrapezoidProfile& profile, double start, double goal, double startVelocity,
+        double maxAcceleration = LIMITS.maxAcceleration) {
+        const int failuresBefore = test::failures;
+        const double duration = profile.getDuration();
+        const ls::ProfileState first = profile.sample(0);
+        CHECK(std::fabs(first.position - start) < EPSILON);
+        CHECK(std::fabs(first.velocity - startVelocity) < EPSILON);
+
+        double peak = 0;
+        ls::ProfileState previous = first;
+        for (double t = DT; t < duration + 0.05; t += DT) {
+            const ls::ProfileState state = profile.sample(t);
+            // the position moves by the average velocity, so neither jumps
+            const double step = state.position - previous.position;
+            CHECK(std::fabs(step - (state.velocity + previous.velocity) / 2 * DT) < maxAcceleration * DT * DT);
+            CHECK(std::fabs(state.velocity - previous.velocity) <= maxAcceleration * DT + EPSILON);
+            CHECK(std::fabs(state.velocity) <= LIMITS.maxVelocity + EPSILON);
+            CHECK(std::fabs(state.acceleration) <= maxAcceleration + EPSILON);
+            CHECK((goal - state.position) * (goal - start) >= -EPSILON); // never past the goal
+            peak = std::fmax(peak, std::fabs(state.velocity));
+            previous = state;
+        }
+
+        for (double t : {duration, duration + 1}) {
+            const ls::ProfileState end = profile.sample(t);
+            CHECK(end.position == goal && end.velocity == 0 && end.acceleration == 0);
+        }
+        std::printf("%-14s %.3f s, peak %.1f%s\n", name, duration, peak, test::failures != failuresBefore ? " FAILED" : "");
+        return peak;
+    }
+}
+
+int main() {
+    // long enough to cruise at the max velocity
+    CHECK(std::fabs(check("trapezoid up", ls::TrapezoidProfile(LIMITS, -60, 130), -60, 130, 0) - LIMITS.maxVelocity) < EPSILON);
+    CHECK(std::fabs(check("trapezoid down", ls::TrapezoidProfile(LIMITS, 130, -40), 130, -40, 0) - LIMITS.maxVelocity) < EPSILON);
+
+    // too short to reach it
+    const double trianglePeak = check("triangle", ls::TrapezoidProfile(LIMITS, 20, 30), 20, 30, 0);
+    CHECK(trianglePeak < LIMITS.maxVelocity && std::fabs(trianglePeak - std::sqrt(LIMITS.maxAcceleration * 10)) < 2);
+
+    // a move replacing one that was still running
+    check("moving start", ls::TrapezoidProfile(LIMITS, 0, 100, 200), 0, 100, 200);
+
+    // too fast to stop in time at the limit, it decelerates harder
+    const double hardest = 300.0 * 300 / (2 * 5);
+    check("overspeed", ls::TrapezoidProfile(LIMITS, 0, 5, 300), 0, 5, 300, hardest);
+
+    // moving away from the goal, that part is left to the feedback
+    check("backwards", ls::TrapezoidProfile(LIMITS, 0, 100, -200), 0, 100, 0);
+
+    const ls::TrapezoidProfile still(LIMITS, 10, 10);
+    CHECK(still.getDuration() == 0);
+    check("zero length", still, 10, 10, 0);
+    check("default", ls::TrapezoidProfile(), 0, 0, 0);
+
+    bool threw = false;
+    try {
+        ls::TrapezoidProfile({0, 100}, 0, 10);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    return test::result();
+}
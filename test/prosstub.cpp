@@ -0,0 +1,93 @@
+#include "prosstub.h"
+#include <cstdarg>
+#include <utility>
+#include <vector>
+#include "api.h"
+
+namespace {
+    std::uint64_t fakeClock = 0; // in us
+    std::vector<std::pair<pros::task_fn_t, void*>> tasks;
+    std::function<void()> delayHook;
+    std::uint64_t filled = 0;
+}
+
+namespace test {
+    void setTime(std::uint32_t ms) {
+        fakeClock = ms * 1000ull;
+    }
+
+    void advance(std::uint32_t ms) {
+        fakeClock += ms * 1000ull;
+    }
+
+    void runTasks() {
+        std::vector<std::pair<pros::task_fn_t, void*>> started;
+        started.swap(tasks);
+        for (auto& [function, parameters] : started) function(parameters);
+    }
+
+    void onDelay(std::function<void()> hook) {
+        delayHook = std::move(hook);
+    }
+
+    std::uint64_t filledPixels() {
+        return filled;
+    }
+}
+
+extern "C" {
+    uint32_t millis(void) {
+        return static_cast<uint32_t>(fakeClock / 1000);
+    }
+
+    uint64_t micros(void) {
+        return fakeClock;
+    }
+
+    uint32_t screen_print_at(pros::text_format_e_t, const int16_t, const int16_t, const char*, ...) {
+        return 1;
+    }
+}
+
+namespace pros {
+    inline namespace rtos {
+        Task::Task(task_fn_t function, void* parameters, std::uint32_t, std::uint16_t, const char*) {
+            tasks.emplace_back(function, parameters);
+        }
+
+        void Task::join() {}
+
+        void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+            *prev_time += delta;
+            if (*prev_time > millis()) test::setTime(*prev_time);
+            if (delayHook) delayHook();
+        }
+
+        // tests run on one thread, nothing is shared
+        Mutex::Mutex() {}
+        void Mutex::lock() {}
+        void Mutex::unlock() {}
+    }
+
+    inline namespace v5 {
+        // no controller is connected, tests feed Input snapshots instead
+        Controller::Controller(controller_id_e_t id) : _id(id) {}
+        std::int32_t Controller::is_connected() { return 0; }
+        std::int32_t Controller::get_analog(controller_analog_e_t) { return 0; }
+        std::int32_t Controller::get_digital(controller_digital_e_t) { return 0; }
+    }
+
+    namespace screen {
+        std::uint32_t set_pen(pros::Color) { return 1; }
+        std::uint32_t set_pen(std::uint32_t) { return 1; }
+        std::uint32_t set_eraser(pros::Color) { return 1; }
+        std::uint32_t erase_rect(const std::int16_t, const std::int16_t, const std::int16_t, const std::int16_t) { return 1; }
+        std::uint32_t draw_line(const std::int16_t, const std::int16_t, const std::int16_t, const std::int16_t) { return 1; }
+        std::uint32_t fill_circle(const std::int16_t, const std::int16_t, const std::int16_t) { return 1; }
+
+        std::uint32_t fill_rect(const std::int16_t x0, const std::int16_t y0, const std::int16_t x1, const std::int16_t y1) {
+            filled += static_cast<std::uint64_t>(x1 - x0 + 1) * (y1 - y0 + 1);
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/*
+* Contains the controls of the PROS stand-ins in prosstub.cpp, for host tests of code that includes api.h.
+* Only the calls those tests reach are defined. Time is a fake clock that moves only when a test moves it,
+* and tasks are recorded instead of started.
+*/
+#ifndef PROSSTUB_TEST_H
+#define PROSSTUB_TEST_H
+
+#include <cstdint>
+#include <functional>
+
+namespace test {
+    /**
+     * @brief Sets the fake clock read by pros::millis() and pros::micros().
+     */
+    void setTime(std::uint32_t ms);
+
+    /**
+     * @brief Moves the fake clock forwards.
+     */
+    void advance(std::uint32_t ms);
+
+    /**
+     * @brief Runs every task started since the last call, one after the other, on the calling thread.
+     * A task runs until its function returns.
+     */
+    void runTasks();
+
+    /**
+     * @brief Sets a function called after every pros::Task::delay_until() moved the clock, ex. to feed
+     * a task's inputs or stop it. Empty to call nothing.
+     */
+    void onDelay(std::function<void()> hook);
+
+    /**
+     * @brief Gets the number of screen pixels filled by pros::screen::fill_rect() so far.
+     */
+    std::uint64_t filledPixels();
+}
+
+#endif // PROSSTUB_TEST_H
@@ -0,0 +1,67 @@
+/*
+* Steps ls::StallDetector at the 10ms tick with an intake's speed and current, and checks a jam is flagged within
+* 70ms while load bumps, slow light loads, spin up and direction changes are not.
+*/
+#include <cstdio>
+#include "check.h"
+#include "stall.h"
+
+namespace {
+    constexpr float DT = 0.01f; // in seconds
+    constexpr int TICK = 10; // in ms
+
+    /**
+     * @brief Gives the same measurements for 'ms' and returns how long it took to be Stalled, -1 if it never was.
+     */
+    int run(ls::StallDetector& detector, int ms, float volts, float rpm, float current) {
+        for (int t = TICK; t <= ms; t += TICK) {
+            if (detector.update(volts, rpm, current, DT) == ls::StallState::Stalled) return t;
+        }
+        return -1;
+    }
+}
+
+int main() {
+    ls::StallDetector detector;
+
+    // starting slow and drawing a lot is spinning up, not a jam
+    CHECK(run(detector, 100, 12, 50, 2000) == -1);
+    CHECK(detector.getState() == ls::StallState::SpinUp);
+    CHECK(run(detector, 300, 12, 190, 600) == -1);
+    CHECK(detector.getState() == ls::StallState::Running);
+
+    // a ring catching for 40ms
+    CHECK(run(detector, 40, 12, 20, 2200) == -1);
+    CHECK(detector.getState() == ls::StallState::Suspect);
+    CHECK(run(detector, 100, 12, 190, 600) == -1);
+    CHECK(detector.getState() == ls::StallState::Running);
+
+    // a jam
+    const int flagged = run(detector, 200, 12, 5, 2400);
+    std::printf("jam flagged after %d ms\n", flagged);
+    CHECK(flagged > 0 && flagged <= 70);
+    CHECK(run(detector, 100, 12, 190, 600) == TICK); // it stays Stalled until reset()
+
+    // backing out spins up again
+    detector.reset();
+    CHECK(run(detector, 50, -12, 0, 2400) == -1);
+    CHECK(detector.getState() == ls::StallState::SpinUp);
+
+    // slow at a low voltage, but lightly loaded
+    CHECK(run(detector, 1000, 4, 20, 300) == -1);
+    CHECK(detector.getState() == ls::StallState::Running);
+    // the same speed drawing the stall current for 4V is a jam
+    CHECK(run(detector, 100, 4, 5, 700) > 0);
+
+    // a direction change restarts the spin up
+    detector.reset();
+    run(detector, 300, 12, 190, 600);
+    CHECK(run(detector, 100, -12, 100, 2400) == -1);
+    CHECK(detector.getState() == ls::StallState::SpinUp);
+
+    // commands under minVoltage are not checked
+    detector.reset();
+    CHECK(run(detector, 1000, 2, 0, 2400) == -1);
+    CHECK(detector.getState() == ls::StallState::Idle);
+    return test::result();
+}
@@ -0,0 +1,117 @@
+/*
+* Feeds ls::VelocityEstimator a constant-acceleration trace with jittery timestamps and a quantized ADI encoder trace,
+* checks the errors claimed for it against the millis() single difference it replaced, and times update().
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include "check.h"
+#include "velocity.h"
+
+namespace {
+    constexpr std::uint64_t START = 90'000'000; // 1:30 into a match, in µs, so the timestamps are large
+    constexpr double PERIOD = 10'000; // the odom loop, in µs
+    constexpr double JITTER = 800; // in µs, either way
+    constexpr double TICK = 1.375 * 3.14159265358979323846 / 180; // one degree of a 2.75" ADI tracking wheel, in in
+
+    /**
+     * @brief The old TrackingWheel::getLinearSpeed() on an ADI encoder: the last tick difference over millis().
+     */
+    struct SingleDifference {
+        double previousDistance = 0;
+        double previousTime = 0;
+
+        double update(double distance, std::uint64_t micros) {
+            const double time = micros / 1000 / 1000.0;
+            const double speed = (distance - previousDistance) / (time - previousTime);
+            previousDistance = distance;
+            previousTime = time;
+            return speed;
+        }
+    };
+
+    volatile double sink; // keeps the timed loop from being optimized out
+}
+
+int main() {
+    std::mt19937 random(3201);
+    std::uniform_real_distribution<double> jitter(-JITTER, JITTER);
+
+    // constant acceleration, which the quadratic fit follows exactly
+    {
+        ls::VelocityEstimator estimator;
+        constexpr double V0 = 12, A = 30;
+        double velocityError = 0, accelerationError = 0;
+        for (int i = 0; i < 300; i++) {
+            const std::uint64_t now = START + static_cast<std::uint64_t>(i * PERIOD + jitter(random));
+            const double t = (now - START) * 1e-6;
+            estimator.update(V0 * t + A * t * t / 2, now);
+            if (i < 2) continue;
+            velocityError = std::fmax(velocityError, std::fabs(estimator.getVelocity() - (V0 + A * t)));
+            accelerationError = std::fmax(accelerationError, std::fabs(estimator.getAcceleration() - A));
+        }
+        std::printf("constant acceleration: velocity error %.3g in/s, acceleration error %.3g in/s²\n",
+            velocityError, accelerationError);
+        CHECK(velocityError < 2.5e-10);
+        CHECK(accelerationError < 6.6e-9);
+    }
+
+    // 20 in/s read off an ADI encoder one degree at a time, against the single difference on the same samples
+    {
+        ls::VelocityEstimator estimator;
+        SingleDifference single;
+        constexpr double SPEED = 20;
+        double estimatorSquares = 0, singleSquares = 0;
+        int samples = 0;
+        for (int i = 0; i < 3000; i++) {
+            const std::uint64_t now = START + static_cast<std::uint64_t>(i * PERIOD + jitter(random));
+            const double distance = std::floor((now - START) * 1e-6 * SPEED / TICK) * TICK;
+            estimator.update(distance, now);
+            const double singleSpeed = single.update(distance, now);
+            if (i < 8) continue; // until the window is full
+            estimatorSquares += std::pow(estimator.getVelocity() - SPEED, 2);
+            singleSquares += std::pow(singleSpeed - SPEED, 2);
+            samples++;
+        }
+        const double estimatorRms = std::sqrt(estimatorSquares / samples);
+        const double singleRms = std::sqrt(singleSquares / samples);
+        std::printf("ADI at %.0f in/s: RMS error %.3f in/s, single difference %.3f in/s\n", SPEED, estimatorRms, singleRms);
+        CHECK(estimatorRms < 0.4);
+        CHECK(singleRms > 3 * estimatorRms);
+    }
+
+    // a sample at the same time replaces the last one, and the estimate is 0 until there are enough
+    {
+        ls::VelocityEstimator estimator(3);
+        estimator.update(1, START);
+        CHECK(estimator.getVelocity() == 0 && estimator.getSampleCount() == 1);
+        estimator.update(2, START + 10'000);
+        CHECK(std::fabs(estimator.getVelocity() - 100) < 1e-9 && estimator.getAcceleration() == 0);
+        estimator.update(3, START + 10'000);
+        CHECK(estimator.getSampleCount() == 2 && std::fabs(estimator.getVelocity() - 200) < 1e-9);
+        estimator.reset();
+        CHECK(estimator.getSampleCount() == 0 && estimator.getVelocity() == 0);
+    }
+
+    bool threw = false;
+    try {
+        ls::VelocityEstimator(ls::VelocityEstimator::MAX_WINDOW + 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // the cost of one update with the default window
+    constexpr int COUNT = 1 << 20;
+    ls::VelocityEstimator estimator;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COUNT; i++) estimator.update(i * 0.2, START + i * 10'000ull);
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = estimator.getVelocity();
+    const double perUpdate = elapsed.count() / COUNT;
+    std::printf("update: %.1f ns\n", perUpdate);
+    CHECK(perUpdate < 50 * 4); // host timing is noisy, this only catches it getting a lot slower
+    return test::result();
+}
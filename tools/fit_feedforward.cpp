@@ -0,0 +1,80 @@
+/*
+* Refits the drive feedforward gains from a characterize.csv copied off the SD card.
+* Uses the same ls::FeedforwardFit as the Characterize routine, so the result matches what the robot would save,
+* but the cutoffs can be changed and bad phases left out without driving the runs again.
+*
+* usage: fit_feedforward characterize.csv [feedforward.txt] [min linear in/s] [min angular rad/s]
+* Giving feedforward.txt writes the gains in the format the robot loads at boot.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "feedforward.h"
+
+namespace {
+    // the cutoffs characterize.cpp fits with on the robot.
+    constexpr double MIN_LINEAR_SPEED = 0.5; // in in/s
+    constexpr double MIN_ANGULAR_SPEED = 0.05; // in rad/s
+
+    void report(const char* name, const ls::FeedforwardFit& fit, const ls::FeedforwardGains& gains) {
+        std::printf("%-8s kS %.4f  kV %.5f  kA %.5f  r^2 %.5f  (%zu samples)\n", name, gains.kS, gains.kV, gains.kA,
+            fit.getRSquared(), fit.getCount());
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s characterize.csv [feedforward.txt] [min linear in/s] [min angular rad/s]\n", argv[0]);
+        return 2;
+    }
+    std::FILE* file = std::fopen(argv[1], "r");
+    if (file == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+    ls::FeedforwardFit linear(argc > 3 ? std::atof(argv[3]) : MIN_LINEAR_SPEED);
+    ls::FeedforwardFit angular(argc > 4 ? std::atof(argv[4]) : MIN_ANGULAR_SPEED);
+
+    char line[256];
+    std::size_t lineNumber = 0;
+    std::size_t skipped = 0;
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        if (lineNumber == 1 && std::strncmp(line, "time,", 5) == 0) continue; // header
+        unsigned long time;
+        char phase[64];
+        double voltage, velocity, acceleration;
+        if (std::sscanf(line, "%lu,%63[^,],%lf,%lf,%lf", &time, phase, &voltage, &velocity, &acceleration) != 5) {
+            skipped++;
+            continue;
+        }
+        // phases are named "linear ..." or "angular ..." by characterize.cpp
+        if (std::strncmp(phase, "linear", 6) == 0) {
+            linear.add(voltage, velocity, acceleration);
+        } else if (std::strncmp(phase, "angular", 7) == 0) {
+            angular.add(voltage, velocity, acceleration);
+        } else {
+            skipped++;
+        }
+    }
+    std::fclose(file);
+    if (skipped != 0) std::printf("skipped %zu unreadable lines\n", skipped);
+
+    const ls::FeedforwardGains linearGains = linear.solve();
+    const ls::FeedforwardGains angularGains = angular.solve();
+    report("linear", linear, linearGains);
+    report("angular", angular, angularGains);
+    if (linearGains.kV <= 0 || angularGains.kV <= 0) {
+        std::fprintf(stderr, "fit failed, the log needs both quasistatic and dynamic runs\n");
+        return 1;
+    }
+
+    if (argc > 2) {
+        if (!ls::saveFeedforward(argv[2], linearGains, angularGains)) {
+            std::fprintf(stderr, "could not write %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("wrote %s\n", argv[2]);
+    }
+    return 0;
+}